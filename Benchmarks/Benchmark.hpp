@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+struct BenchmarkResult
+{
+	std::string label;
+	double value;
+	std::string_view unit;
+};
+
+using BenchmarkEntryPointFn = void(*)(std::vector<BenchmarkResult>& outResults);
+
+struct BenchmarkListing
+{
+	std::string_view category;
+	std::string_view name;
+	BenchmarkEntryPointFn entry_point;
+};
+
+std::vector<BenchmarkListing>& get_benchmarks();
+std::monostate register_benchmark(std::string_view category, std::string_view name, BenchmarkEntryPointFn entryPoint);
+
+#define DeclBenchmark(category, name)\
+	void category##_##name##_benchmark_main(std::vector<BenchmarkResult>& outResults);\
+	static auto category##_##name##_benchmark_state = register_benchmark(#category, #category "_" #name, category##_##name##_benchmark_main);\
+	void category##_##name##_benchmark_main(std::vector<BenchmarkResult>& outResults)
+
+#define Report(label, value, unit) outResults.emplace_back(label, value, unit)
+
+// Prevents the compiler from optimizing away the computation of value
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+// Runs func once and returns how long it took in seconds
+template<typename Func>
+double measure_seconds(Func&& func)
+{
+	const auto start = std::chrono::steady_clock::now();
+	func();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(end - start).count();
+}
@@ -0,0 +1,102 @@
+#include "Benchmark.hpp"
+
+#include <ConcurrentHashMap.hpp>
+
+#include <algorithm>
+#include <format>
+#include <mutex>
+#include <thread>
+
+using namespace CSTM;
+
+static constexpr size_t KeyCount = 1 << 16;
+static constexpr size_t OperationsPerThread = 1 << 20;
+
+// NOTE(Peter): One in WriteInterval operations is a write, the rest are lookups
+static constexpr size_t WriteInterval = 16;
+
+// Runs threadCount threads that all call func(threadIndex), returns millions of operations per second
+template<typename Func>
+static double run_threads(size_t threadCount, Func&& func)
+{
+	const double seconds = measure_seconds([&]
+	{
+		std::vector<std::jthread> threads;
+
+		for (size_t t = 0; t < threadCount; t++)
+		{
+			threads.emplace_back(func, t);
+		}
+	});
+
+	return static_cast<double>(threadCount * OperationsPerThread) / seconds / 1'000'000.0;
+}
+
+// Runs the read-mostly workload against map, lookup and write are called with a key
+template<typename Lookup, typename Write>
+static void run_workload(size_t threadIndex, Lookup&& lookup, Write&& write)
+{
+	uint64_t state = 0x9E37'79B9'7F4A'7C15 * (threadIndex + 1);
+	size_t found = 0;
+
+	for (size_t i = 0; i < OperationsPerThread; i++)
+	{
+		// xorshift64
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+
+		const size_t key = state % KeyCount;
+
+		if (i % WriteInterval == 0)
+		{
+			write(key);
+		}
+		else
+		{
+			found += lookup(key);
+		}
+	}
+
+	do_not_optimize(found);
+}
+
+DeclBenchmark(concurrent_hash_map, read_mostly_throughput)
+{
+	const size_t maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+	{
+		HashMap<size_t, size_t> lockedMap;
+		std::mutex mutex;
+		lockedMap.reserve(KeyCount);
+
+		ConcurrentHashMap<size_t, size_t> concurrentMap;
+		concurrentMap.reserve(KeyCount);
+
+		for (size_t key = 0; key < KeyCount; key++)
+		{
+			lockedMap.insert(key, key);
+			concurrentMap.insert(key, key);
+		}
+
+		const double lockedThroughput = run_threads(threadCount, [&](size_t threadIndex)
+		{
+			run_workload(threadIndex,
+				[&](size_t key) { std::scoped_lock lock(mutex); return lockedMap.contains(key); },
+				[&](size_t key) { std::scoped_lock lock(mutex); lockedMap.insert_or_assign(key, key + 1); }
+			);
+		});
+
+		const double concurrentThroughput = run_threads(threadCount, [&](size_t threadIndex)
+		{
+			run_workload(threadIndex,
+				[&](size_t key) { return concurrentMap.contains(key); },
+				[&](size_t key) { concurrentMap.insert_or_assign(key, key + 1); }
+			);
+		});
+
+		Report(std::format("HashMap + std::mutex, {} thread(s)", threadCount), lockedThroughput, "Mops/s");
+		Report(std::format("ConcurrentHashMap, {} thread(s)", threadCount), concurrentThroughput, "Mops/s");
+	}
+}
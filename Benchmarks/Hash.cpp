@@ -0,0 +1,83 @@
+#include "Benchmark.hpp"
+
+#include <Hash.hpp>
+
+#include <format>
+#include <numeric>
+#include <string_view>
+
+using namespace CSTM;
+
+static constexpr size_t BytesPerRun = 1 << 26;
+
+// Hashes BytesPerRun bytes worth of byteCount sized inputs, returns GB/s
+template<typename Func>
+static double bytes_throughput(const std::vector<char>& buffer, size_t byteCount, Func&& func)
+{
+	const size_t inputCount = BytesPerRun / byteCount;
+	const size_t offsetMask = buffer.size() - byteCount - 1;
+
+	const double seconds = measure_seconds([&]
+	{
+		size_t result = 0;
+
+		for (size_t i = 0; i < inputCount; i++)
+		{
+			// NOTE(Peter): Varying the offset keeps the compiler from hoisting the hash out of the loop
+			result += func(std::string_view{ buffer.data() + ((i * 64) & offsetMask), byteCount });
+		}
+
+		do_not_optimize(result);
+	});
+
+	return static_cast<double>(inputCount * byteCount) / seconds / 1'000'000'000.0;
+}
+
+DeclBenchmark(hash, bytes_throughput)
+{
+	std::vector<char> buffer(1 << 16);
+	std::iota(buffer.begin(), buffer.end(), char{ 0 });
+
+	for (size_t byteCount : { 8, 16, 32, 64, 256, 4096 })
+	{
+		const double stdThroughput = bytes_throughput(buffer, byteCount, [](std::string_view str)
+		{
+			return std::hash<std::string_view>{}(str);
+		});
+
+		const double cstmThroughput = bytes_throughput(buffer, byteCount, [](std::string_view str)
+		{
+			return hash_bytes(str.data(), str.size(), 0x1234'5678);
+		});
+
+		Report(std::format("std::hash<std::string_view>, {} bytes", byteCount), stdThroughput, "GB/s");
+		Report(std::format("hash_bytes, {} bytes", byteCount), cstmThroughput, "GB/s");
+	}
+}
+
+DeclBenchmark(hash, integer_throughput)
+{
+	constexpr size_t HashCount = 1 << 26;
+
+	auto run = [](auto&& func)
+	{
+		const double seconds = measure_seconds([&]
+		{
+			size_t result = 0;
+
+			for (uint64_t i = 0; i < HashCount; i++)
+			{
+				result += func(i);
+			}
+
+			do_not_optimize(result);
+		});
+
+		return static_cast<double>(HashCount) / seconds / 1'000'000.0;
+	};
+
+	// NOTE(Peter): std::hash<uint64_t> is usually the identity function, so it has to be mixed before a
+	//				hash table can use it, which is what the old GlobalSeed ^ std::hash + hash_mix did
+	Report("std::hash<uint64_t> + hash_mix", run([](uint64_t v) { return hash_mix(0x1234'5678 ^ std::hash<uint64_t>{}(v)); }), "Mhash/s");
+	Report("hash_integer", run([](uint64_t v) { return hash_integer(v, 0x1234'5678); }), "Mhash/s");
+}
@@ -0,0 +1,54 @@
+#include "Benchmark.hpp"
+
+#include <print>
+
+std::vector<BenchmarkListing>& get_benchmarks()
+{
+	static std::vector<BenchmarkListing> benchmarks;
+	return benchmarks;
+}
+
+std::monostate register_benchmark(std::string_view category, std::string_view name, BenchmarkEntryPointFn entryPoint)
+{
+	get_benchmarks().emplace_back(
+		category,
+		name,
+		entryPoint
+	);
+	return {};
+}
+
+int main(int argc, char* argv[])
+{
+	for (const auto& benchmark : get_benchmarks())
+	{
+		if (argc > 1)
+		{
+			bool executeBenchmark = false;
+
+			for (int i = 1; i < argc; i++)
+			{
+				if (benchmark.category == argv[i])
+				{
+					executeBenchmark = true;
+					break;
+				}
+			}
+
+			if (!executeBenchmark)
+			{
+				continue;
+			}
+		}
+
+		std::vector<BenchmarkResult> results;
+		benchmark.entry_point(results);
+
+		std::println("[\u001B[36mBENCH\u001B[0m]: {}", benchmark.name);
+
+		for (const auto& result : results)
+		{
+			std::println("\t- {}: {:.2f} {}", result.label, result.value, result.unit);
+		}
+	}
+}
@@ -0,0 +1,188 @@
+#include "Benchmark.hpp"
+
+#include <String.hpp>
+#include <StringView.hpp>
+
+#include <algorithm>
+#include <format>
+#include <string_view>
+#include <thread>
+
+using namespace CSTM;
+
+static constexpr size_t StringsPerThread = 1 << 18;
+
+// Every thread creates and immediately drops large strings picked by pick(threadIndex, i), returns Mstrings/s
+template<typename Pick>
+static double pool_throughput(size_t threadCount, const std::vector<std::string>& strings, Pick&& pick)
+{
+	const double seconds = measure_seconds([&]
+	{
+		std::vector<std::jthread> threads;
+
+		for (size_t t = 0; t < threadCount; t++)
+		{
+			threads.emplace_back([&, t]
+			{
+				for (size_t i = 0; i < StringsPerThread; i++)
+				{
+					const auto str = String::create(strings[pick(t, i)]);
+					do_not_optimize(str.data());
+				}
+			});
+		}
+	});
+
+	return static_cast<double>(threadCount * StringsPerThread) / seconds / 1'000'000.0;
+}
+
+DeclBenchmark(string, pool_contention)
+{
+	std::vector<std::string> strings;
+
+	for (size_t i = 0; i < 1024; i++)
+	{
+		strings.push_back(std::format("Content-Type: application/x-benchmark-{}", i));
+	}
+
+	// NOTE(Peter): Keeping one reference alive means that creating a string only has to find it in the pool
+	std::vector<String> pinned;
+
+	for (const auto& str : strings)
+	{
+		pinned.push_back(String::create(str));
+	}
+
+	const size_t maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+	{
+		// Every thread interns the same string, the worst case since they all need the same shard
+		const double sameString = pool_throughput(threadCount, strings, [](size_t, size_t) { return 0; });
+
+		// Threads intern different strings that are already in the pool
+		const double pinnedStrings = pool_throughput(threadCount, strings, [](size_t t, size_t i) { return (i * 7 + t * 131) % 1024; });
+
+		Report(std::format("Same string, {} thread(s)", threadCount), sameString, "Mstrings/s");
+		Report(std::format("Pooled strings, {} thread(s)", threadCount), pinnedStrings, "Mstrings/s");
+	}
+
+	pinned.clear();
+
+	for (size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+	{
+		// Nothing is pinned anymore, so every string is created and destroyed again
+		const double transient = pool_throughput(threadCount, strings, [](size_t t, size_t i) { return (i * 7 + t * 131) % 1024; });
+		Report(std::format("Transient strings, {} thread(s)", threadCount), transient, "Mstrings/s");
+	}
+}
+
+DeclBenchmark(string, small_string_hit_rate)
+{
+	// NOTE(Peter): Typical short strings from web services, header names, JSON keys, identifiers and small values
+	const std::vector<std::string_view> tokens = {
+		"Accept", "Accept-Encoding", "Accept-Language", "Authorization", "Cache-Control", "Connection",
+		"Content-Length", "Content-Type", "Cookie", "Host", "If-None-Match", "Last-Modified", "Origin",
+		"Referer", "User-Agent", "X-Forwarded-For", "X-Request-Id", "Access-Control-Allow-Origin",
+		"Strict-Transport-Security", "application/json", "text/html; charset=utf-8", "gzip, deflate, br",
+		"id", "name", "email", "created_at", "updated_at", "user_id", "display_name", "first_name", "last_name",
+		"phone_number", "is_active", "profile_image_url", "billing_address", "shipping_address", "postal_code",
+		"country_code", "order_id", "total_price", "currency", "payment_method", "transaction_reference",
+		"std::vector", "std::unordered_map", "operator==", "try_decrease_ref_count", "CodePointIterator",
+		"BasicConcurrentHashMap", "remove_trailing_code_points", "true", "false", "null", "2024-03-14",
+		"2024-03-14T15:09:26Z", "en-US,en;q=0.9", "127.0.0.1", "550e8400-e29b-41d4-a716-446655440000",
+	};
+
+	// The inline capacity before the layout change, the remaining bytes were taken up by the byte count
+	constexpr size_t PreviousSmallStringLength = 16;
+
+	const auto countInline = [&](size_t smallStringLength)
+	{
+		return std::ranges::count_if(tokens, [=](std::string_view token) { return token.size() <= smallStringLength; });
+	};
+
+	const double tokenCount = static_cast<double>(tokens.size());
+	Report(std::format("Inline at {} bytes", PreviousSmallStringLength), 100.0 * countInline(PreviousSmallStringLength) / tokenCount, "%");
+	Report(std::format("Inline at {} bytes", String::SmallStringLength), 100.0 * countInline(String::SmallStringLength) / tokenCount, "%");
+
+	constexpr size_t CreateCount = 1 << 22;
+
+	const double seconds = measure_seconds([&]
+	{
+		for (size_t i = 0; i < CreateCount; i++)
+		{
+			const auto str = String::create(tokens[i % tokens.size()]);
+			do_not_optimize(str.data());
+		}
+	});
+
+	Report("Creating tokens", static_cast<double>(CreateCount) / seconds / 1'000'000.0, "Mstrings/s");
+}
+
+DeclBenchmark(string, cached_code_point_count)
+{
+	static constexpr size_t QueryCount = 1 << 12;
+
+	// A 64KB text node that gets measured over and over again (e.g for layout)
+	std::string text;
+
+	while (text.size() < 64 * 1024)
+	{
+		text += "Съешь же ещё этих мягких французских булок, да выпей чаю. ";
+	}
+
+	const auto str = String::create(text);
+	const auto view = str.view().value();
+
+	const auto queriesPerSecond = [&](const auto& s)
+	{
+		const double seconds = measure_seconds([&]
+		{
+			for (size_t i = 0; i < QueryCount; i++)
+			{
+				do_not_optimize(s.code_point_count());
+				do_not_optimize(s.is_ascii());
+			}
+		});
+
+		return static_cast<double>(QueryCount) / seconds / 1'000'000.0;
+	};
+
+	Report("StringView (counted every time)", queriesPerSecond(view), "Mqueries/s");
+	Report("String (cached in the storage)", queriesPerSecond(str), "Mqueries/s");
+}
+
+DeclBenchmark(string, code_point_at)
+{
+	std::string text;
+
+	while (text.size() < 64 * 1024)
+	{
+		text += "Съешь же ещё этих мягких французских булок, да выпей чаю. ";
+	}
+
+	const auto str = String::create(text);
+	const auto view = str.view().value();
+	const size_t codePointCount = str.code_point_count();
+
+	// for i in 0..n: code_point_at(i), which used to be quadratic
+	const auto lookupsPerSecond = [&](const auto& s)
+	{
+		const double seconds = measure_seconds([&]
+		{
+			uint32_t sum = 0;
+
+			for (size_t i = 0; i < codePointCount; i++)
+			{
+				sum += s.code_point_at(i).value_or(0);
+			}
+
+			do_not_optimize(sum);
+		});
+
+		return static_cast<double>(codePointCount) / seconds / 1'000'000.0;
+	};
+
+	Report("StringView (skips from the start)", lookupsPerSecond(view), "Mlookups/s");
+	Report("String (CodePointIndex)", lookupsPerSecond(str), "Mlookups/s");
+}
@@ -0,0 +1,133 @@
+#include "Benchmark.hpp"
+
+#include <String.hpp>
+
+#include <algorithm>
+#include <format>
+#include <string>
+#include <string_view>
+
+using namespace CSTM;
+
+static constexpr size_t SearchesPerRun = 64;
+
+// Searches the haystack SearchesPerRun times, returns GB/s
+template<typename Func>
+static double search_throughput(std::string_view haystack, Func&& func)
+{
+	const double seconds = measure_seconds([&]
+	{
+		for (size_t i = 0; i < SearchesPerRun; i++)
+		{
+			do_not_optimize(func());
+		}
+	});
+
+	return static_cast<double>(haystack.size() * SearchesPerRun) / seconds / 1'000'000'000.0;
+}
+
+DeclBenchmark(string_search, find)
+{
+	// NOTE(Peter): Roughly 1MB of markup that doesn't contain any of the needles until the very end
+	std::string haystack;
+
+	for (size_t i = 0; haystack.size() < 1024 * 1024; i++)
+	{
+		haystack += std::format("<div class=\"item-{}\"><a href=\"/items/{}\">Item number {}</a><span>Some text</span></div>\n", i, i, i);
+	}
+
+	haystack += "</body>\r\n\r\n";
+
+	const auto str = String::create_unique(haystack);
+
+	const std::string_view needles[] = {
+		"\r\n\r\n",
+		"</body>",
+		"<span class=\"missing\">",
+		"<section id=\"a-needle-long-enough-to-use-the-two-way-algorithm\">",
+	};
+
+	for (std::string_view needle : needles)
+	{
+		const double searchThroughput = search_throughput(haystack, [&]
+		{
+			return std::ranges::search(haystack, needle).begin();
+		});
+
+		const double stdThroughput = search_throughput(haystack, [&]
+		{
+			return std::string_view{ haystack }.find(needle);
+		});
+
+		const double findThroughput = search_throughput(haystack, [&]
+		{
+			return str.find(needle);
+		});
+
+		std::string escapedNeedle{ needle };
+		std::ranges::replace(escapedNeedle, '\r', 'r');
+		std::ranges::replace(escapedNeedle, '\n', 'n');
+
+		Report(std::format("std::ranges::search, \"{}\"", escapedNeedle), searchThroughput, "GB/s");
+		Report(std::format("std::string_view::find, \"{}\"", escapedNeedle), stdThroughput, "GB/s");
+		Report(std::format("StringBase::find, \"{}\"", escapedNeedle), findThroughput, "GB/s");
+	}
+
+	const double rfindThroughput = search_throughput(haystack, [&]
+	{
+		return str.rfind("<html>");
+	});
+
+	Report("StringBase::rfind, \"<html>\"", rfindThroughput, "GB/s");
+}
+
+DeclBenchmark(string_search, find_first_of)
+{
+	// NOTE(Peter): Text without any of the delimiters, so every search has to look at every byte
+	std::string haystack;
+
+	for (size_t i = 0; haystack.size() < 1024 * 1024; i++)
+	{
+		haystack += std::format("Lorem ipsum dolor sit amet {} consectetur adipiscing elit ", i);
+	}
+
+	const auto str = String::create_unique(haystack);
+
+	for (std::string_view chars : { std::string_view{ "<>" }, std::string_view{ "\r\n\t\"&;#" }, std::string_view{ "!$%()*+/:=?@[]^`{|}~" } })
+	{
+		// What contains_any used to do, look for every byte in chars
+		const double containsThroughput = search_throughput(haystack, [&]
+		{
+			for (size_t i = 0; i < haystack.size(); i++)
+			{
+				if (std::ranges::contains(chars, haystack[i]))
+				{
+					return i;
+				}
+			}
+
+			return NotFound;
+		});
+
+		const double stdThroughput = search_throughput(haystack, [&]
+		{
+			return std::string_view{ haystack }.find_first_of(chars);
+		});
+
+		const double findThroughput = search_throughput(haystack, [&]
+		{
+			return str.find_first_of(chars);
+		});
+
+		Report(std::format("std::ranges::contains per byte, {} chars", chars.size()), containsThroughput, "GB/s");
+		Report(std::format("std::string_view::find_first_of, {} chars", chars.size()), stdThroughput, "GB/s");
+		Report(std::format("StringBase::find_first_of, {} chars", chars.size()), findThroughput, "GB/s");
+	}
+
+	const double removeThroughput = search_throughput(haystack, [&]
+	{
+		return str.remove_any(" ,").value().byte_count();
+	});
+
+	Report("String::remove_any, 2 chars", removeThroughput, "GB/s");
+}
@@ -0,0 +1,122 @@
+#include "Benchmark.hpp"
+
+#include <CodePointIterator.hpp>
+#include <String.hpp>
+#include <Unicode.hpp>
+
+#include <format>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace CSTM;
+
+static constexpr size_t RunsPerCorpus = 16;
+
+// Each of these takes a different path through the decoder
+static constexpr std::pair<std::string_view, std::string_view> Corpora[] = {
+	{ "ASCII", "The quick brown fox jumps over the lazy dog, then naps in the afternoon sun (for a while). " },
+	{ "Latin-1", "Le cœur déçu mais l'âme plutôt naïve, Louÿs rêva de crapaüter en canoë au delà des îles. " },
+	{ "Cyrillic", "Съешь же ещё этих мягких французских булок, да выпей чаю. " },
+	{ "CJK", "敏捷的棕色狐狸跳过了懒狗，然后在下午的阳光下小睡了一会儿。" },
+};
+
+// Runs func over the corpus RunsPerCorpus times, returns GB/s
+template<typename Func>
+static double decode_throughput(const String& corpus, Func&& func)
+{
+	const double seconds = measure_seconds([&]
+	{
+		for (size_t i = 0; i < RunsPerCorpus; i++)
+		{
+			do_not_optimize(func());
+		}
+	});
+
+	return static_cast<double>(corpus.byte_count() * RunsPerCorpus) / seconds / 1'000'000'000.0;
+}
+
+// Roughly 1MB worth of copies of text
+static String make_corpus(std::string_view text)
+{
+	std::string corpus;
+
+	while (corpus.size() < 1024 * 1024)
+	{
+		corpus += text;
+	}
+
+	return String::create_unique(corpus);
+}
+
+DeclBenchmark(unicode, decode)
+{
+	for (const auto& [name, text] : Corpora)
+	{
+		const auto corpus = make_corpus(text);
+
+		// What CodePointIterator used to do, decode one code point at a time through utf8_to_utf32
+		const double scalarThroughput = decode_throughput(corpus, [&]
+		{
+			const byte* current = corpus.data();
+			const byte* end = current + corpus.byte_count();
+			uint32_t sum = 0;
+
+			// NOTE(Peter): Stops 4 bytes early since utf8_to_utf32 always reads 4 bytes
+			while (current + 4 <= end)
+			{
+				uint32_t byteCount = 0;
+				sum += utf8_to_utf32({ current[0], current[1], current[2], current[3] }, byteCount).value_or(0);
+				current += byteCount;
+			}
+
+			return sum;
+		});
+
+		const double eachThroughput = decode_throughput(corpus, [&]
+		{
+			uint32_t sum = 0;
+			CodePointIterator{ corpus }.each([&](uint32_t codePoint) { sum += codePoint; });
+			return sum;
+		});
+
+		const double storeThroughput = decode_throughput(corpus, [&]
+		{
+			std::vector<uint32_t> codePoints;
+			CodePointIterator{ corpus }.store(codePoints);
+			return codePoints.size();
+		});
+
+		const double countThroughput = decode_throughput(corpus, [&]
+		{
+			return CodePointIterator{ corpus }.count();
+		});
+
+		const double codePointCountThroughput = decode_throughput(corpus, [&]
+		{
+			return corpus.code_point_count();
+		});
+
+		Report(std::format("utf8_to_utf32 per code point, {}", name), scalarThroughput, "GB/s");
+		Report(std::format("CodePointIterator::each, {}", name), eachThroughput, "GB/s");
+		Report(std::format("CodePointIterator::store, {}", name), storeThroughput, "GB/s");
+		Report(std::format("CodePointIterator::count, {}", name), countThroughput, "GB/s");
+		Report(std::format("String::code_point_count, {}", name), codePointCountThroughput, "GB/s");
+	}
+}
+
+DeclBenchmark(unicode, validate)
+{
+	for (const auto& [name, text] : Corpora)
+	{
+		const auto corpus = make_corpus(text);
+
+		const double validateThroughput = decode_throughput(corpus, [&]
+		{
+			return validate_utf8(corpus.data(), corpus.byte_count());
+		});
+
+		Report(std::format("validate_utf8, {}", name), validateThroughput, "GB/s");
+	}
+}
@@ -0,0 +1,67 @@
+#include "Allocator.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace CSTM {
+
+	Arena::~Arena() noexcept
+	{
+		while (m_chunks != nullptr)
+		{
+			free_chunk(std::exchange(m_chunks, m_chunks->previous));
+		}
+	}
+
+	void Arena::reset() noexcept
+	{
+		if (m_chunks == nullptr)
+		{
+			return;
+		}
+
+		while (m_chunks->previous != nullptr)
+		{
+			Chunk* chunk = m_chunks->previous;
+			m_chunks->previous = chunk->previous;
+			m_reserved_byte_count -= chunk->byte_count;
+			free_chunk(chunk);
+		}
+
+		m_current = reinterpret_cast<byte*>(m_chunks + 1);
+	}
+
+	void* Arena::allocate_slow(size_t byteCount, size_t alignment)
+	{
+		// NOTE(Peter): Worst case we have to skip alignment - 1 bytes after the chunk header
+		const size_t requiredByteCount = sizeof(Chunk) + byteCount + alignment - 1;
+
+		auto* chunk = static_cast<Chunk*>(::operator new(std::max(requiredByteCount, m_chunk_size)));
+		chunk->byte_count = std::max(requiredByteCount, m_chunk_size);
+		m_reserved_byte_count += chunk->byte_count;
+
+		// Large allocations get a chunk of their own, that way we can keep bumping into the current chunk
+		if (m_chunks != nullptr && requiredByteCount > m_chunk_size / 4)
+		{
+			chunk->previous = m_chunks->previous;
+			m_chunks->previous = chunk;
+			return align_up(reinterpret_cast<byte*>(chunk + 1), alignment);
+		}
+
+		chunk->previous = m_chunks;
+		m_chunks = chunk;
+
+		m_current = reinterpret_cast<byte*>(chunk + 1);
+		m_end = reinterpret_cast<byte*>(chunk) + chunk->byte_count;
+
+		byte* memory = align_up(m_current, alignment);
+		m_current = memory + byteCount;
+		return memory;
+	}
+
+	void Arena::free_chunk(Chunk* chunk) noexcept
+	{
+		::operator delete(static_cast<void*>(chunk));
+	}
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <new>
+
+namespace CSTM {
+
+	/*
+	 * Allocation policy used by CSTM containers. Unlike std::allocator an allocator hands out untyped memory,
+	 * since containers like BasicHashMap store several different types in a single allocation.
+	 * Allocators are copied along with the container, so stateful allocators should be cheap handles (see ArenaAllocator).
+	 */
+	template<typename A>
+	concept Allocator = std::copy_constructible<A> && requires(A& allocator, void* memory, size_t byteCount, size_t alignment)
+	{
+		{ allocator.allocate(byteCount, alignment) } -> std::same_as<void*>;
+		allocator.deallocate(memory, byteCount, alignment);
+	};
+
+	// Allocates from the global heap (operator new)
+	struct DefaultAllocator
+	{
+		[[nodiscard]]
+		void* allocate(size_t byteCount, size_t alignment) const
+		{
+			return ::operator new(byteCount, std::align_val_t{ alignment });
+		}
+
+		void deallocate(void* memory, size_t, size_t alignment) const noexcept
+		{
+			::operator delete(memory, std::align_val_t{ alignment });
+		}
+	};
+
+	/*
+	 * Bump allocator that hands out memory from large chunks, and frees everything at once when it's reset or destroyed.
+	 * Meant for short-lived data (e.g everything allocated while handling a single request), where allocating is
+	 * just a pointer increment and individual deallocations can be skipped entirely.
+	 *
+	 * NOTE(Peter): An Arena is NOT thread-safe, and nothing allocated from it may outlive it (or a call to reset)
+	 */
+	class Arena
+	{
+	public:
+		static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+		explicit Arena(size_t chunkSize = DefaultChunkSize) noexcept
+			: m_chunk_size(chunkSize)
+		{}
+
+		Arena(const Arena&) = delete;
+		Arena(Arena&&) = delete;
+		Arena& operator=(const Arena&) = delete;
+		Arena& operator=(Arena&&) = delete;
+
+		~Arena() noexcept;
+
+		[[nodiscard]]
+		void* allocate(size_t byteCount, size_t alignment)
+		{
+			byte* memory = align_up(m_current, alignment);
+
+			if (memory == nullptr || byteCount > static_cast<size_t>(m_end - memory))
+			{
+				return allocate_slow(byteCount, alignment);
+			}
+
+			m_current = memory + byteCount;
+			return memory;
+		}
+
+		// NOTE(Peter): Memory is only reclaimed if it's the most recent allocation, anything else is freed by reset
+		void deallocate(void* memory, size_t byteCount) noexcept
+		{
+			if (static_cast<byte*>(memory) + byteCount == m_current)
+			{
+				m_current = static_cast<byte*>(memory);
+			}
+		}
+
+		// Frees everything that was allocated from this arena, keeping the most recent chunk around for reuse
+		void reset() noexcept;
+
+		// Total number of bytes reserved from the heap, including unused space at the end of each chunk
+		[[nodiscard]]
+		size_t reserved_byte_count() const noexcept { return m_reserved_byte_count; }
+
+	private:
+		struct Chunk
+		{
+			Chunk* previous;
+			size_t byte_count;
+		};
+
+		[[nodiscard]]
+		static byte* align_up(byte* ptr, size_t alignment) noexcept
+		{
+			const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+			return reinterpret_cast<byte*>((address + alignment - 1) & ~(alignment - 1));
+		}
+
+		void* allocate_slow(size_t byteCount, size_t alignment);
+
+		static void free_chunk(Chunk* chunk) noexcept;
+
+	private:
+		byte* m_current = nullptr;
+		byte* m_end = nullptr;
+		Chunk* m_chunks = nullptr;
+		size_t m_chunk_size;
+		size_t m_reserved_byte_count = 0;
+	};
+
+	// Allocator handle that allocates from an Arena
+	class ArenaAllocator
+	{
+	public:
+		ArenaAllocator(Arena& arena) noexcept
+			: m_arena(&arena)
+		{}
+
+		[[nodiscard]]
+		void* allocate(size_t byteCount, size_t alignment) const
+		{
+			return m_arena->allocate(byteCount, alignment);
+		}
+
+		void deallocate(void* memory, size_t byteCount, size_t) const noexcept
+		{
+			m_arena->deallocate(memory, byteCount);
+		}
+
+		[[nodiscard]]
+		Arena& arena() const noexcept { return *m_arena; }
+
+	private:
+		Arena* m_arena;
+	};
+
+}
@@ -0,0 +1,56 @@
+#include "CodePointIndex.hpp"
+#include "Unicode.hpp"
+
+#include <algorithm>
+
+namespace CSTM {
+
+	CodePointIndex::CodePointIndex(const byte* bytes, size_t byteCount)
+		: m_bytes(bytes), m_byte_count(byteCount)
+	{
+		// NOTE(Peter): Chunks can't hold more than Stride / 2 code points, so at least half of them don't contain an indexed code point
+		static constexpr size_t ChunkSize = Stride / 2;
+
+		m_offsets.reserve(byteCount / Stride + 1);
+
+		for (size_t offset = 0; offset < byteCount; offset += ChunkSize)
+		{
+			const size_t chunkSize = std::min(ChunkSize, byteCount - offset);
+			const size_t chunkCodePoints = count_code_points(bytes + offset, chunkSize);
+
+			// Chunks without an indexed code point are skipped without looking at individual bytes
+			if (m_code_point_count + chunkCodePoints <= m_offsets.size() * Stride)
+			{
+				m_code_point_count += chunkCodePoints;
+				continue;
+			}
+
+			for (size_t i = offset; i < offset + chunkSize; i++)
+			{
+				if ((bytes[i] & 0xC0) == 0x80)
+				{
+					continue;
+				}
+
+				if (m_code_point_count == m_offsets.size() * Stride)
+				{
+					m_offsets.push_back(i);
+				}
+
+				m_code_point_count++;
+			}
+		}
+	}
+
+	size_t CodePointIndex::byte_offset(size_t index) const noexcept
+	{
+		if (index >= m_code_point_count)
+		{
+			return m_byte_count;
+		}
+
+		const size_t start = m_offsets[index / Stride];
+		return start + code_point_offset(m_bytes + start, m_byte_count - start, index % Stride);
+	}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace CSTM {
+
+	/*
+	 * Sparse index from code points to byte offsets, it remembers where every Stride-th code point starts.
+	 * Looking up a code point jumps to the closest one before it and skips at most Stride - 1 code points from there
+	 * (see code_point_offset), so random access costs about the same no matter where in the bytes the code point is.
+	 * Code points are counted the same way count_code_points does.
+	 * NOTE(Peter): Only keeps a pointer to the bytes, they have to outlive the index
+	 */
+	class CodePointIndex
+	{
+	public:
+		static constexpr size_t Stride = 64;
+
+	public:
+		CodePointIndex(const byte* bytes, size_t byteCount);
+
+		// Byte offset of the code point at index, or the byte count if index is past the last code point
+		[[nodiscard]]
+		size_t byte_offset(size_t index) const noexcept;
+
+		[[nodiscard]]
+		size_t code_point_count() const noexcept { return m_code_point_count; }
+
+	private:
+		const byte* m_bytes;
+		size_t m_byte_count;
+		size_t m_code_point_count = 0;
+
+		// m_offsets[i] is the byte offset of code point i * Stride
+		std::vector<size_t> m_offsets;
+	};
+
+}
@@ -1,69 +1,70 @@
 #include "CodePointIterator.hpp"
-#include "Assert.hpp"
 #include "Unicode.hpp"
-#include "StringBase.hpp"
 
-namespace CSTM {
-
-	CodePointIteratorBase::CodePointIteratorBase(const byte* current, const byte* end)
-		: m_current(current), m_end(end)
-	{
-	}
-
-	void CodePointIteratorBase::compute_current_code_point()
-	{
-		uint32_t codePointByteCount = 0;
-		const auto codePoint = utf8_to_utf32({ m_current[0], m_current[1], m_current[2], m_current[3] }, codePointByteCount);
-		CSTM_Assert(codePoint.has_value());
-		m_code_point.value = codePoint.value();
-		m_code_point.byteCount = codePointByteCount;
-	}
+#include <algorithm>
 
-	CodePointIterator::CodePointIterator(const StringBase& str)
-		: CodePointIteratorBase(str.data(), str.data() + str.byte_count())
-	{
-	}
+namespace CSTM {
 
-	bool CodePointIterator::advance()
+	template<bool Reverse>
+	bool BasicCodePointIterator<Reverse>::decode_next_block() noexcept
 	{
-		if (m_current + m_code_point.byteCount >= m_end)
+		if (m_begin == m_end)
 		{
 			return false;
 		}
 
-		m_current += m_code_point.byteCount;
+		if constexpr (Reverse)
+		{
+			// NOTE(Peter): Every byte decodes to at most one code point, so the last BufferSize bytes always fit
+			const byte* blockBegin = m_end - std::min<size_t>(m_end - m_begin, BufferSize);
+			const byte* sequenceBegin = blockBegin;
+
+			// Don't start decoding in the middle of a sequence, unless the bytes before it aren't ours to decode
+			while (blockBegin != m_begin && sequenceBegin != m_end && !is_leading_byte(*sequenceBegin))
+			{
+				sequenceBegin++;
+			}
 
-		CSTM_Assert(is_leading_byte(*m_current));
+			if (sequenceBegin != m_end)
+			{
+				blockBegin = sequenceBegin;
+			}
 
-		compute_current_code_point();
+			const auto result = decode_utf8(blockBegin, m_end - blockBegin, m_buffer, BufferSize);
+			std::reverse(m_buffer, m_buffer + result.code_point_count);
+			m_buffer_count = static_cast<uint32_t>(result.code_point_count);
+			m_end = blockBegin;
+		}
+		else
+		{
+			const auto result = decode_utf8(m_begin, m_end - m_begin, m_buffer, BufferSize);
+			m_buffer_count = static_cast<uint32_t>(result.code_point_count);
+			m_begin += result.byte_count;
+		}
+
+		m_buffer_index = 0;
 		return true;
 	}
 
-	CodePointReverseIterator::CodePointReverseIterator(const StringBase& str)
-		: CodePointIteratorBase(str.data() + str.byte_count(), str.data())
+	template<bool Reverse>
+	size_t BasicCodePointIterator<Reverse>::count() noexcept
 	{
-	}
+		const size_t c = (m_buffer_count - m_buffer_index) + count_code_points(m_begin, m_end - m_begin);
 
-	bool CodePointReverseIterator::advance()
-	{
-		// 1. Search backwards from m_current until we find a leading byte
-		size_t searchOffset = 1;
-		while (!is_leading_byte(*(m_current - searchOffset)))
+		if constexpr (Reverse)
 		{
-			searchOffset++;
+			m_end = m_begin;
 		}
-
-		if (m_current - searchOffset < m_end)
+		else
 		{
-			return false;
+			m_begin = m_end;
 		}
 
-		// 2. Point m_current to the leading byte
-		m_current -= searchOffset;
-
-		// 3. Read the leading byte + trailing bytes
-		compute_current_code_point();
-		return true;
+		m_buffer_index = m_buffer_count;
+		return c;
 	}
 
+	template class BasicCodePointIterator<false>;
+	template class BasicCodePointIterator<true>;
+
 }
@@ -4,6 +4,7 @@
 #include "Utility.hpp"
 #include "Result.hpp"
 
+#include <algorithm>
 #include <concepts>
 #include <vector>
 
@@ -11,144 +12,151 @@ namespace CSTM {
 
 	class StringBase;
 
-	enum class IterAction
-	{
-		Break, Continue
-	};
-
-	class CodePointIteratorBase
+	/*
+	 * Iterates over the code points of UTF-8 encoded bytes, front to back or back to front if Reverse is set.
+	 * Code points are decoded a block at a time into a small buffer (see decode_utf8), which each, store and count
+	 * then simply walk through. Iterating backwards decodes blocks from the end forwards and walks them in reverse.
+	 * NOTE(Peter): Bytes that aren't valid UTF-8 are iterated as ReplacementCodePoint
+	 */
+	template<bool Reverse>
+	class BasicCodePointIterator
 	{
 	public:
-		CodePointIteratorBase(const byte* current, const byte* end);
+		BasicCodePointIterator(const byte* data, size_t byteCount) noexcept
+			: m_begin(data), m_end(data + byteCount)
+		{}
 
-		virtual ~CodePointIteratorBase() = default;
+		template<typename Str>
+			requires(std::derived_from<Str, StringBase>)
+		explicit BasicCodePointIterator(const Str& str) noexcept
+			: BasicCodePointIterator(str.data(), str.byte_count())
+		{}
 
 		[[nodiscard]]
-		uint32_t current() const noexcept { return m_code_point.value; }
+		uint32_t current() const noexcept { return m_current; }
 
-		virtual bool advance() = 0;
-
-		void each(std::invocable<uint32_t> auto&& func)
+		bool advance()
 		{
-			using ReturnType = std::invoke_result_t<decltype(func), uint32_t>;
-
-			if constexpr (std::same_as<ReturnType, IterAction>)
-			{
-				while (advance())
-				{
-					if (func(current()) == IterAction::Break)
-					{
-						break;
-					}
-				}
-			}
-			else
+			if (m_buffer_index == m_buffer_count && !decode_next_block())
 			{
-				while (advance())
-				{
-					func(current());
-				}
+				return false;
 			}
+
+			m_current = m_buffer[m_buffer_index++];
+			return true;
 		}
 
-		void each(std::invocable<size_t, uint32_t> auto&& func)
+		void each(std::invocable<uint32_t> auto&& func)
 		{
-			using ReturnType = std::invoke_result_t<decltype(func), size_t, uint32_t>;
-
-			size_t i = 0;
-
-			if constexpr (std::same_as<ReturnType, IterAction>)
-			{
-				while (advance())
-				{
-					if (func(i, current()) == IterAction::Break)
-					{
-						break;
-					}
+			each_impl([&](size_t, uint32_t codePoint) { return func(codePoint); });
+		}
 
-					i++;
-				}
-			}
-			else
-			{
-				while (advance())
-				{
-					func(i, current());
-					i++;
-				}
-			}
+		void each(std::invocable<size_t, uint32_t> auto&& func)
+		{
+			each_impl(func);
 		}
 
 		void store(std::vector<uint32_t>& container, size_t start = 0, size_t end = ~0)
 		{
-			each([&](const size_t i, const uint32_t codePoint)
+			size_t i = 0;
+
+			// NOTE(Peter): Copies whole blocks of decoded code points at once, only skipping the ones before start
+			while (i < end && (m_buffer_index < m_buffer_count || decode_next_block()))
 			{
-				if (i < start)
-				{
-					return IterAction::Continue;
-				}
+				const uint32_t* codePoints = m_buffer + m_buffer_index;
+				const size_t codePointCount = m_buffer_count - m_buffer_index;
+				const size_t first = start > i ? std::min(start - i, codePointCount) : 0;
+				const size_t last = std::min(codePointCount, end - i);
 
-				if (i >= end)
+				if (first < last)
 				{
-					return IterAction::Break;
+					container.insert(container.end(), codePoints + first, codePoints + last);
 				}
 
-				container.push_back(codePoint);
-				return IterAction::Continue;
-			});
+				m_buffer_index += static_cast<uint32_t>(last);
+				i += last;
+			}
 		}
 
+		// NOTE(Peter): Walks the code points from the current one, prefer StringBase::code_point_at for random access
 		Result<uint32_t, NullType> code_point_at(size_t index)
 		{
-			uint32_t cp;
+			uint32_t cp = 0;
+			bool found = false;
+
 			each([&](const size_t i, const uint32_t codePoint)
 			{
 				if (i == index)
 				{
 					cp = codePoint;
+					found = true;
 					return IterAction::Break;
 				}
 
 				return IterAction::Continue;
 			});
+
+			if (!found)
+			{
+				return Null;
+			}
+
 			return cp;
 		}
 
-		size_t count()
+		// Counts the remaining code points without decoding them (see count_code_points)
+		size_t count() noexcept;
+
+	private:
+		void each_impl(auto&& func)
 		{
-			size_t c = 0;
-			each([&](const uint32_t){ c++; });
-			return c;
-		}
+			using ReturnType = std::invoke_result_t<decltype(func), size_t, uint32_t>;
 
-	protected:
-		void compute_current_code_point();
+			size_t i = 0;
 
-	protected:
-		const byte* m_current;
-		const byte* m_end;
+			while (m_buffer_index < m_buffer_count || decode_next_block())
+			{
+				for (; m_buffer_index < m_buffer_count; m_buffer_index++, i++)
+				{
+					m_current = m_buffer[m_buffer_index];
 
-		struct CodePoint
-		{
-			uint32_t value = ~0u;
-			uint32_t byteCount = 0;
-		} m_code_point{};
-	};
+					if constexpr (std::same_as<ReturnType, IterAction>)
+					{
+						if (func(i, m_current) == IterAction::Break)
+						{
+							m_buffer_index++;
+							return;
+						}
+					}
+					else
+					{
+						func(i, m_current);
+					}
+				}
+			}
+		}
 
-	class CodePointIterator final : public CodePointIteratorBase
-	{
-	public:
-		explicit CodePointIterator(const StringBase& str);
+		// Refills the buffer with the next code points, returns false once there's nothing left to decode
+		bool decode_next_block() noexcept;
 
-		bool advance() override;
-	};
+	private:
+		static constexpr size_t BufferSize = 64;
 
-	class CodePointReverseIterator final : public CodePointIteratorBase
-	{
-	public:
-		explicit CodePointReverseIterator(const StringBase& str);
+		// Bytes that haven't been decoded yet
+		const byte* m_begin;
+		const byte* m_end;
 
-		bool advance() override;
+		uint32_t m_current = ~0u;
+		uint32_t m_buffer_index = 0;
+		uint32_t m_buffer_count = 0;
+		uint32_t m_buffer[BufferSize];
 	};
 
+	// NOTE(Peter): Both of these are instantiated in CodePointIterator.cpp
+	extern template class BasicCodePointIterator<false>;
+	extern template class BasicCodePointIterator<true>;
+
+	using CodePointIterator = BasicCodePointIterator<false>;
+	using CodePointReverseIterator = BasicCodePointIterator<true>;
+
 }
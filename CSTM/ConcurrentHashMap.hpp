@@ -0,0 +1,291 @@
+#pragma once
+
+#include "HashMap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace CSTM {
+
+	/*
+	 * Hash map that can be used from multiple threads at the same time. The map is split into a number of shards,
+	 * each shard being a BasicHashMap protected by its own reader-writer lock, so threads only contend when they
+	 * touch the same shard, and readers of the same shard never block each other.
+	 *
+	 *	1. The shard of a key is picked from the top bits of its (mixed) hash, BasicHashMap only looks at the lower bits
+	 *		which means that the elements of a shard still spread out over all of its buckets.
+	 *
+	 *	2. References to keys or values can never escape a lock, at returns a copy of the value.
+	 *		Use visit to access a value in place, e.g to avoid copying large values.
+	 *
+	 *	3. Operations that look at the whole map (element_count, for_each, clear) lock one shard at a time,
+	 *		so they're not atomic with respect to other threads modifying the map.
+	 */
+	template<typename Key, typename Value, Hasher<Key> Hash>
+	class BasicConcurrentHashMap
+	{
+		using Map = BasicHashMap<Key, Value, Hash>;
+
+		template<typename K>
+		static constexpr bool IsLookupKey = requires(const Map& map, const K& key) { map.contains(key); };
+
+	public:
+		// NOTE(Peter): The shard index is taken from the top 7 bits of the hash
+		static constexpr size_t MaxShardCount = 128;
+
+		BasicConcurrentHashMap()
+			: BasicConcurrentHashMap(default_shard_count())
+		{}
+
+		// NOTE(Peter): shardCount is rounded up to a power of two, and clamped to MaxShardCount
+		explicit BasicConcurrentHashMap(size_t shardCount)
+		{
+			m_shard_count = std::bit_ceil(std::clamp(shardCount, size_t{ 1 }, MaxShardCount));
+			m_shards = std::make_unique<Shard[]>(m_shard_count);
+		}
+
+		BasicConcurrentHashMap(const BasicConcurrentHashMap&) = delete;
+		BasicConcurrentHashMap& operator=(const BasicConcurrentHashMap&) = delete;
+
+		// Inserts key and value, throws if the key is already present in the map
+		void insert(const Key& key, const Value& value)
+		{
+			const size_t hash = hash_key(key);
+			auto& shard = shard_for(hash);
+			std::unique_lock lock(shard.mutex);
+			shard.map.insert_with_hash(hash, key, value);
+		}
+
+		// Constructs the value from args if key isn't present in the map yet, returns whether anything was inserted
+		template<typename KeyType, typename... Args>
+			requires std::constructible_from<Key, KeyType&&> && std::constructible_from<Value, Args...>
+		bool try_emplace(KeyType&& key, Args&&... args)
+		{
+			Key k(std::forward<KeyType>(key));
+			const size_t hash = hash_key(k);
+			auto& shard = shard_for(hash);
+			std::unique_lock lock(shard.mutex);
+			return shard.map.try_emplace_with_hash(hash, std::move(k), std::forward<Args>(args)...).has_value();
+		}
+
+		// Inserts value if key isn't present in the map yet, otherwise assigns value to the existing value
+		template<typename KeyType, typename V>
+			requires std::constructible_from<Key, KeyType&&> && std::assignable_from<Value&, V&&>
+		void insert_or_assign(KeyType&& key, V&& value)
+		{
+			Key k(std::forward<KeyType>(key));
+			const size_t hash = hash_key(k);
+			auto& shard = shard_for(hash);
+			std::unique_lock lock(shard.mutex);
+			shard.map.insert_or_assign_with_hash(hash, std::move(k), std::forward<V>(value));
+		}
+
+		// Removes key from the map, throws if the key isn't present
+		template<typename K>
+			requires IsLookupKey<K>
+		void remove(const K& key)
+		{
+			if (!try_remove(key))
+			{
+				throw std::runtime_error("Key not present in map!");
+			}
+		}
+
+		// Same as remove, but returns false instead of throwing if the key isn't present
+		template<typename K>
+			requires IsLookupKey<K>
+		bool try_remove(const K& key)
+		{
+			const size_t hash = hash_key(key);
+			auto& shard = shard_for(hash);
+			std::unique_lock lock(shard.mutex);
+			return shard.map.try_remove_with_hash(hash, key);
+		}
+
+		template<typename K>
+			requires IsLookupKey<K>
+		[[nodiscard]]
+		bool contains(const K& key) const
+		{
+			const size_t hash = hash_key(key);
+			const auto& shard = shard_for(hash);
+			std::shared_lock lock(shard.mutex);
+			return shard.map.contains_with_hash(hash, key);
+		}
+
+		// Returns a copy of the value of key, throws if the key isn't present
+		template<typename K>
+			requires IsLookupKey<K>
+		[[nodiscard]]
+		Value at(const K& key) const
+		{
+			const size_t hash = hash_key(key);
+			const auto& shard = shard_for(hash);
+			std::shared_lock lock(shard.mutex);
+
+			if (const Value* value = shard.map.find_with_hash(hash, key))
+			{
+				return *value;
+			}
+
+			throw std::runtime_error("Key not found!");
+		}
+
+		template<typename K>
+			requires IsLookupKey<K>
+		[[nodiscard]]
+		Value operator[](const K& key) const
+		{
+			return at(key);
+		}
+
+		/*
+		 * Calls func with the value of key while holding the lock of its shard, returns false if the key isn't present.
+		 * func gets a mutable reference (and an exclusive lock) unless the map is const.
+		 * NOTE(Peter): func must not access the map itself, since that could try to lock the same shard again
+		 */
+		template<typename K, typename Func>
+			requires IsLookupKey<K>
+		bool visit(this auto&& self, const K& key, Func&& func)
+		{
+			using Self = decltype(self);
+
+			const size_t hash = self.hash_key(key);
+			auto& shard = self.shard_for(hash);
+			auto lock = lock_shard<Self>(shard);
+			auto&& map = std::forward_like<Self>(shard.map);
+
+			if (auto* value = map.find_with_hash(hash, key))
+			{
+				func(*value);
+				return true;
+			}
+
+			return false;
+		}
+
+		// Calls func with every key and value in the map, the same rules as visit apply
+		template<typename Func>
+		void for_each(this auto&& self, Func&& func)
+		{
+			using Self = decltype(self);
+
+			for (size_t i = 0; i < self.m_shard_count; i++)
+			{
+				auto& shard = self.m_shards[i];
+				auto lock = lock_shard<Self>(shard);
+				std::forward_like<Self>(shard.map).for_each(func);
+			}
+		}
+
+		// Makes sure that elementCount (evenly distributed) elements can be present in the map without any shard
+		// having to rehash
+		void reserve(size_t elementCount)
+		{
+			// NOTE(Peter): Keys never distribute perfectly, leave each shard some room for the imbalance
+			const size_t perShard = elementCount / m_shard_count;
+			const size_t shardElementCount = perShard + perShard / 8;
+
+			for (size_t i = 0; i < m_shard_count; i++)
+			{
+				std::unique_lock lock(m_shards[i].mutex);
+				m_shards[i].map.reserve(shardElementCount);
+			}
+		}
+
+		void clear()
+		{
+			for (size_t i = 0; i < m_shard_count; i++)
+			{
+				std::unique_lock lock(m_shards[i].mutex);
+				m_shards[i].map.clear();
+			}
+		}
+
+		[[nodiscard]]
+		size_t element_count() const
+		{
+			size_t elementCount = 0;
+
+			for (size_t i = 0; i < m_shard_count; i++)
+			{
+				std::shared_lock lock(m_shards[i].mutex);
+				elementCount += m_shards[i].map.element_count();
+			}
+
+			return elementCount;
+		}
+
+		[[nodiscard]]
+		bool is_empty() const { return element_count() == 0; }
+
+		[[nodiscard]]
+		size_t shard_count() const noexcept { return m_shard_count; }
+
+	private:
+		// NOTE(Peter): Each shard gets its own cache line(s) so that locking one shard doesn't invalidate the lock
+		//				of a neighboring shard in the caches of other cores
+		struct alignas(64) Shard
+		{
+			mutable std::shared_mutex mutex;
+			Map map;
+		};
+
+		[[nodiscard]]
+		static size_t default_shard_count() noexcept
+		{
+			// More shards than threads keeps the chance of two threads wanting the same shard low
+			const size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+			return std::clamp(std::bit_ceil(threadCount * 4), size_t{ 16 }, MaxShardCount);
+		}
+
+		/*
+		 * The hash is computed once, it picks the shard and is then handed to the *_with_hash functions of the shard map,
+		 * which would otherwise hash the key again (e.g all of a long String under SecureHash).
+		 * NOTE(Peter): This relies on the shard maps using a default constructed Hash as well, which BasicHashMap always does
+		 */
+		template<typename K>
+		[[nodiscard]]
+		size_t hash_key(const K& key) const noexcept
+		{
+			return mixed_hash(m_hasher, key);
+		}
+
+		[[nodiscard]]
+		auto& shard_for(this auto&& self, const size_t hash) noexcept
+		{
+			constexpr size_t ShardShift = std::numeric_limits<size_t>::digits - std::countr_zero(MaxShardCount);
+			return self.m_shards[(hash >> ShardShift) & (self.m_shard_count - 1)];
+		}
+
+		// Shared lock for const maps, exclusive lock otherwise
+		template<typename Self>
+		[[nodiscard]]
+		static auto lock_shard(const Shard& shard)
+		{
+			if constexpr (std::is_const_v<std::remove_reference_t<Self>>)
+			{
+				return std::shared_lock(shard.mutex);
+			}
+			else
+			{
+				return std::unique_lock(shard.mutex);
+			}
+		}
+
+	private:
+		std::unique_ptr<Shard[]> m_shards;
+		size_t m_shard_count = 0;
+		CSTM_NoUniqueAddr Hash m_hasher;
+	};
+
+	template<typename Key, typename Value, Hasher<Key> Hash = std::hash<Key>>
+	using ConcurrentHashMap = BasicConcurrentHashMap<Key, Value, SecureHash<Key, Hash>>;
+
+}
@@ -2,7 +2,11 @@
 
 #include "Utility.hpp"
 
+#include <cstring>
+#include <limits>
 #include <random>
+#include <ranges>
+#include <string_view>
 
 namespace CSTM {
 
@@ -12,27 +16,242 @@ namespace CSTM {
 		{ H{}(t) } -> std::same_as<size_t>;
 	};
 
+	// Transparent hashers can hash types other than the key type, which allows lookups without constructing a key
+	template<typename H>
+	concept TransparentHasher = requires { typename H::is_transparent; };
+
+	template<typename Hash>
+	struct TransparentHashBase {};
+
+	template<TransparentHasher Hash>
+	struct TransparentHashBase<Hash>
+	{
+		using is_transparent = void;
+	};
+
+	struct WideProduct
+	{
+		uint64_t low;
+		uint64_t high;
+	};
+
+	// Multiplies a and b into a full 128-bit result
+	constexpr WideProduct multiply_wide(const uint64_t a, const uint64_t b) noexcept
+	{
+#if defined(__SIZEOF_INT128__)
+		const unsigned __int128 result = static_cast<unsigned __int128>(a) * b;
+		return { static_cast<uint64_t>(result), static_cast<uint64_t>(result >> 64) };
+#else
+		const uint64_t aLow = a & 0xFFFF'FFFF, aHigh = a >> 32;
+		const uint64_t bLow = b & 0xFFFF'FFFF, bHigh = b >> 32;
+
+		const uint64_t lowLow = aLow * bLow;
+		const uint64_t highLow = aHigh * bLow;
+		const uint64_t lowHigh = aLow * bHigh;
+		const uint64_t highHigh = aHigh * bHigh;
+
+		const uint64_t cross = (lowLow >> 32) + (highLow & 0xFFFF'FFFF) + lowHigh;
+		const uint64_t low = (cross << 32) | (lowLow & 0xFFFF'FFFF);
+		const uint64_t high = (highLow >> 32) + (cross >> 32) + highHigh;
+		return { low, high };
+#endif
+	}
+
+	// Multiplies a and b into a 128-bit result and folds the high half into the low half
+	constexpr uint64_t multiply_fold(const uint64_t a, const uint64_t b) noexcept
+	{
+		const auto [low, high] = multiply_wide(a, b);
+		return low ^ high;
+	}
+
+	/*
+	* Spreads the entropy of a hash value across all of its bits. Hashers like std::hash<int> are usually the identity
+	* function, which would make sequential keys cluster once a hash table masks off the lower bits.
+	*/
+	constexpr size_t hash_mix(const size_t hash) noexcept
+	{
+		// NOTE(Peter): 2^64 / golden ratio, the same constant used by fibonacci hashing
+		return static_cast<size_t>(multiply_fold(hash, 0x9E37'79B9'7F4A'7C15));
+	}
+
+	// Hashers whose results are already uniformly distributed over all bits, these don't need to go through hash_mix
+	template<typename H>
+	concept AvalanchingHasher = requires { typename H::is_avalanching; };
+
+	// Hashes key with hasher and makes sure that the result is usable by a hash table
+	template<typename Hash, typename K>
+	constexpr size_t mixed_hash(const Hash& hasher, const K& key)
+	{
+		if constexpr (AvalanchingHasher<Hash>)
+		{
+			return hasher(key);
+		}
+		else
+		{
+			return hash_mix(hasher(key));
+		}
+	}
+
+	// NOTE(Peter): Arbitrary odd constants with roughly half of their bits set, taken from rapidhash
+	constexpr uint64_t HashSecrets[3] = { 0x2D35'8DCC'AA6C'78A5, 0x8BB8'4B93'962E'ACC9, 0x4B33'A62E'D433'D4A3 };
+
+	/*
+	* Seeded hash for integers (and anything that fits in 64 bits). The seed is part of the multiplication,
+	* so without knowing the seed it's not possible to predict which values will collide.
+	*/
+	constexpr size_t hash_integer(const uint64_t value, const uint64_t seed = 0) noexcept
+	{
+		const auto [low, high] = multiply_wide(value ^ HashSecrets[1], seed ^ HashSecrets[0]);
+		return static_cast<size_t>(multiply_fold(low ^ HashSecrets[0], high ^ HashSecrets[1]));
+	}
+
+	/*
+	* Seeded hash for arbitrary bytes, based on rapidhash (the successor of wyhash). Reads 16 bytes per multiplication
+	* (48 per iteration for long inputs) and passes SMHasher, it is NOT a cryptographic hash.
+	* NOTE(Peter): The result depends on the endianness of the platform, never store or send these hashes anywhere.
+	*/
+	inline size_t hash_bytes(const void* data, const size_t byteCount, uint64_t seed = 0) noexcept
+	{
+		auto read64 = [](const byte* p) { uint64_t v; std::memcpy(&v, p, sizeof(v)); return v; };
+		auto read32 = [](const byte* p) { uint32_t v; std::memcpy(&v, p, sizeof(v)); return static_cast<uint64_t>(v); };
+
+		const byte* p = static_cast<const byte*>(data);
+		uint64_t a = 0, b = 0;
+
+		// NOTE(Peter): rapidhash mixes the seed with a multiplication first, we skip that since the seeds
+		//				we use are random anyways, and it's a significant part of the cost for short inputs
+		seed ^= HashSecrets[2] ^ byteCount;
+
+		if (byteCount <= 16)
+		{
+			if (byteCount >= 4)
+			{
+				// NOTE(Peter): Two (possibly overlapping) pairs of 4 byte reads cover every length from 4 to 16
+				const byte* last = p + byteCount - 4;
+				const size_t delta = (byteCount & 24) >> (byteCount >> 3);
+				a = (read32(p) << 32) | read32(last);
+				b = (read32(p + delta) << 32) | read32(last - delta);
+			}
+			else if (byteCount > 0)
+			{
+				a = (uint64_t{ p[0] } << 56) | (uint64_t{ p[byteCount >> 1] } << 32) | p[byteCount - 1];
+			}
+		}
+		else
+		{
+			size_t remaining = byteCount;
+
+			if (remaining > 48)
+			{
+				// Three independent lanes so the multiplications can execute in parallel
+				uint64_t seed1 = seed, seed2 = seed;
+
+				do
+				{
+					seed = multiply_fold(read64(p) ^ HashSecrets[0], read64(p + 8) ^ seed);
+					seed1 = multiply_fold(read64(p + 16) ^ HashSecrets[1], read64(p + 24) ^ seed1);
+					seed2 = multiply_fold(read64(p + 32) ^ HashSecrets[2], read64(p + 40) ^ seed2);
+					p += 48;
+					remaining -= 48;
+				} while (remaining >= 48);
+
+				seed ^= seed1 ^ seed2;
+			}
+
+			if (remaining > 16)
+			{
+				seed = multiply_fold(read64(p) ^ HashSecrets[2], read64(p + 8) ^ seed ^ HashSecrets[1]);
+
+				if (remaining > 32)
+				{
+					seed = multiply_fold(read64(p + 16) ^ HashSecrets[2], read64(p + 24) ^ seed);
+				}
+			}
+
+			// NOTE(Peter): The last 16 bytes are always read, even if that means reading some bytes twice
+			a = read64(p + remaining - 16);
+			b = read64(p + remaining - 8);
+		}
+
+		const auto [low, high] = multiply_wide(a ^ HashSecrets[1], b ^ seed);
+		return static_cast<size_t>(multiply_fold(low ^ HashSecrets[0] ^ byteCount, high ^ HashSecrets[1]));
+	}
+
+	// Hashers that can incorporate a seed into the hash themselves (e.g StringHash), their results have to be
+	// uniformly distributed over all bits
+	template<typename H, typename T>
+	concept SeededHasher = requires(const H& hasher, const T& value, uint64_t seed)
+	{
+		{ hasher(value, seed) } -> std::same_as<size_t>;
+	};
+
 	/*
 	* SecureHash employs "secure" hash generation which incorporates a random seed (generated at runtime)
 	* into the hash to ensure unpredictable hash values, which can help mitigate hash collision attacks as well as
 	* hash flooding attacks.
+	* The seed is folded into the hash function itself (see hash_integer and hash_bytes), which means that keys that
+	* collide for one seed don't collide for another.
 	*/
 
 	template<typename Key, Hasher<Key> Hash = std::hash<Key>>
-	struct SecureHash
+	struct SecureHash : TransparentHashBase<Hash>
 	{
-		inline static uint32_t GlobalSeed = []
+		using is_avalanching = void;
+
+		inline static uint64_t GlobalSeed = []
 		{
 			std::random_device rd;
-			std::uniform_int_distribution<uint32_t> dist(0, std::numeric_limits<uint32_t>::max());
+			std::uniform_int_distribution<uint64_t> dist(0, std::numeric_limits<uint64_t>::max());
 			return dist(rd);
 		}();
 
 		size_t operator()(const Key& key) const
 		{
-			return GlobalSeed ^ hasher(key);
+			return hash(key);
 		}
 
+		template<typename K>
+			requires TransparentHasher<Hash> && Hasher<Hash, K>
+		size_t operator()(const K& key) const
+		{
+			return hash(key);
+		}
+
+	private:
+		template<typename K>
+		size_t hash(const K& key) const
+		{
+			// NOTE(Peter): std::hash is bypassed for types that we can hash (better) ourselves, any other hasher
+			//				gets its result mixed with the seed, which is weaker since collisions of the hasher remain
+			constexpr bool IsStdHash = std::same_as<Hash, std::hash<Key>>;
+
+			if constexpr (SeededHasher<Hash, K>)
+			{
+				return hasher(key, GlobalSeed);
+			}
+			else if constexpr (IsStdHash && (std::integral<K> || std::is_enum_v<K>))
+			{
+				return hash_integer(static_cast<uint64_t>(key), GlobalSeed);
+			}
+			else if constexpr (IsStdHash && std::is_pointer_v<K>)
+			{
+				return hash_integer(reinterpret_cast<uintptr_t>(key), GlobalSeed);
+			}
+			else if constexpr (IsStdHash && IsStdStringLike<K>)
+			{
+				return hash_bytes(key.data(), key.size() * sizeof(typename K::value_type), GlobalSeed);
+			}
+			else
+			{
+				return hash_integer(hasher(key), GlobalSeed);
+			}
+		}
+
+		// std::basic_string and std::basic_string_view
+		template<typename K>
+		static constexpr bool IsStdStringLike = requires { typename K::traits_type; } && std::ranges::contiguous_range<K>;
+
+	public:
 		CSTM_NoUniqueAddr Hash hasher;
 	};
 
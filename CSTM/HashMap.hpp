@@ -1,16 +1,230 @@
 #pragma once
 
+#include "Allocator.hpp"
 #include "Assert.hpp"
 #include "Hash.hpp"
 #include "Result.hpp"
+#include "SIMD.hpp"
 
-#include <vector>
-#include <list>
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <memory>
+#include <new>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
 #include <initializer_list>
+#include <iterator>
 
 namespace CSTM {
 
+	/*
+	 * Every slot in a BasicHashMap has an associated control byte. Control bytes with the high bit set
+	 * mark the slot as not holding an element, full slots instead store the lower 7 bits of the key hash (H2).
+	 */
+	struct HashControl
+	{
+		static constexpr int8_t Empty = -128;	// 0b1000'0000
+		static constexpr int8_t Deleted = -2;	// 0b1111'1110
+
+		[[nodiscard]]
+		static constexpr bool is_full(const int8_t control) noexcept { return control >= 0; }
+	};
+
+	// Mask with one set bit (or byte, see Shift) per matching slot of a ControlGroup, iterating it yields slot offsets
+	template<std::unsigned_integral T, uint32_t Shift>
+	class GroupBitMask
+	{
+	public:
+		constexpr explicit GroupBitMask(T mask) noexcept
+			: m_mask(mask) {}
+
+		[[nodiscard]]
+		constexpr explicit operator bool() const noexcept { return m_mask != 0; }
+
+		[[nodiscard]]
+		constexpr uint32_t trailing_zeros() const noexcept { return std::countr_zero(m_mask) >> Shift; }
+
+		[[nodiscard]]
+		constexpr uint32_t leading_zeros() const noexcept { return std::countl_zero(m_mask) >> Shift; }
+
+		[[nodiscard]]
+		constexpr uint32_t operator*() const noexcept { return trailing_zeros(); }
+
+		constexpr GroupBitMask& operator++() noexcept
+		{
+			m_mask &= m_mask - 1;
+			return *this;
+		}
+
+		[[nodiscard]]
+		constexpr GroupBitMask begin() const noexcept { return *this; }
+
+		[[nodiscard]]
+		constexpr GroupBitMask end() const noexcept { return GroupBitMask{ 0 }; }
+
+		[[nodiscard]]
+		constexpr bool operator==(const GroupBitMask& other) const noexcept = default;
+
+	private:
+		T m_mask;
+	};
+
+	/*
+	 * A ControlGroup is a window of Width consecutive control bytes that is matched as a whole,
+	 * a single compare tests every slot in the group against a H2 tag (or for empty slots).
+	 */
+#if defined(CSTM_SIMD_AVX2)
+	class ControlGroup
+	{
+	public:
+		static constexpr size_t Width = 32;
+
+		explicit ControlGroup(const int8_t* control) noexcept
+			: m_control(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(control))) {}
+
+		[[nodiscard]]
+		GroupBitMask<uint32_t, 0> match(const int8_t tag) const noexcept
+		{
+			return GroupBitMask<uint32_t, 0>{ to_mask(_mm256_cmpeq_epi8(_mm256_set1_epi8(tag), m_control)) };
+		}
+
+		[[nodiscard]]
+		GroupBitMask<uint32_t, 0> match_empty() const noexcept
+		{
+			return GroupBitMask<uint32_t, 0>{ to_mask(_mm256_cmpeq_epi8(_mm256_set1_epi8(HashControl::Empty), m_control)) };
+		}
+
+		// Matches empty and deleted slots, e.g every control byte with the high bit set
+		[[nodiscard]]
+		GroupBitMask<uint32_t, 0> match_free() const noexcept
+		{
+			return GroupBitMask<uint32_t, 0>{ to_mask(m_control) };
+		}
+
+		[[nodiscard]]
+		GroupBitMask<uint32_t, 0> match_full() const noexcept
+		{
+			return GroupBitMask<uint32_t, 0>{ ~to_mask(m_control) };
+		}
+
+	private:
+		static uint32_t to_mask(__m256i v) noexcept { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+
+	private:
+		__m256i m_control;
+	};
+#elif defined(CSTM_SIMD_SSE2)
+	class ControlGroup
+	{
+	public:
+		static constexpr size_t Width = 16;
+
+		explicit ControlGroup(const int8_t* control) noexcept
+			: m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))) {}
+
+		[[nodiscard]]
+		GroupBitMask<uint16_t, 0> match(const int8_t tag) const noexcept
+		{
+			return GroupBitMask<uint16_t, 0>{ to_mask(_mm_cmpeq_epi8(_mm_set1_epi8(tag), m_control)) };
+		}
+
+		[[nodiscard]]
+		GroupBitMask<uint16_t, 0> match_empty() const noexcept
+		{
+			return GroupBitMask<uint16_t, 0>{ to_mask(_mm_cmpeq_epi8(_mm_set1_epi8(HashControl::Empty), m_control)) };
+		}
+
+		// Matches empty and deleted slots, e.g every control byte with the high bit set
+		[[nodiscard]]
+		GroupBitMask<uint16_t, 0> match_free() const noexcept
+		{
+			return GroupBitMask<uint16_t, 0>{ to_mask(m_control) };
+		}
+
+		[[nodiscard]]
+		GroupBitMask<uint16_t, 0> match_full() const noexcept
+		{
+			return GroupBitMask<uint16_t, 0>{ static_cast<uint16_t>(~to_mask(m_control)) };
+		}
+
+	private:
+		static uint16_t to_mask(__m128i v) noexcept { return static_cast<uint16_t>(_mm_movemask_epi8(v)); }
+
+	private:
+		__m128i m_control;
+	};
+#else
+	// NOTE(Peter): Portable fallback that treats 8 control bytes as a single 64-bit integer (SWAR),
+	//				every match sets the high bit of the matching byte, hence the shift of 3 in the bit mask
+	class ControlGroup
+	{
+		static constexpr uint64_t LowBits = 0x0101010101010101;
+		static constexpr uint64_t HighBits = 0x8080808080808080;
+
+	public:
+		static constexpr size_t Width = 8;
+
+		explicit ControlGroup(const int8_t* control) noexcept
+		{
+			std::memcpy(&m_control, control, sizeof(m_control));
+
+			if constexpr (std::endian::native == std::endian::big)
+			{
+				m_control = std::byteswap(m_control);
+			}
+		}
+
+		// NOTE(Peter): This can report false positives for bytes directly following a real match,
+		//				that's fine since every match is verified by comparing the keys anyway
+		[[nodiscard]]
+		GroupBitMask<uint64_t, 3> match(const int8_t tag) const noexcept
+		{
+			const uint64_t x = m_control ^ (LowBits * static_cast<uint8_t>(tag));
+			return GroupBitMask<uint64_t, 3>{ (x - LowBits) & ~x & HighBits };
+		}
+
+		// Empty is the only control value with the high bit set and bit 1 cleared
+		[[nodiscard]]
+		GroupBitMask<uint64_t, 3> match_empty() const noexcept
+		{
+			return GroupBitMask<uint64_t, 3>{ m_control & ~(m_control << 6) & HighBits };
+		}
+
+		// Matches empty and deleted slots, e.g every control byte with the high bit set
+		[[nodiscard]]
+		GroupBitMask<uint64_t, 3> match_free() const noexcept
+		{
+			return GroupBitMask<uint64_t, 3>{ m_control & HighBits };
+		}
+
+		[[nodiscard]]
+		GroupBitMask<uint64_t, 3> match_full() const noexcept
+		{
+			return GroupBitMask<uint64_t, 3>{ ~m_control & HighBits };
+		}
+
+	private:
+		uint64_t m_control;
+	};
+#endif
+
+	enum class HashMapError
+	{
+		KeyAlreadyPresent
+	};
+
+	// Passed to the bulk insertion functions of BasicHashMap to promise that no key is already present in the map,
+	// and that the inserted range itself contains no duplicates. This skips the duplicate probe for every element.
+	CSTM_TagType(UniqueKeysTag);
+
+	constexpr UniqueKeysTag UniqueKeys = UniqueKeysTag{};
+
+	// NOTE(Peter): Scalar keys are cheaper to hash and compare than it is to load a cached hash
+	template<typename Key>
+	constexpr bool CacheHashesByDefault = !std::is_scalar_v<Key>;
+
 	/*
 	 * Hash map implementation meant to solve some of the design flaws of std::unordered_map:
 	 *	1. The subscript operator of this hash map will NEVER modify the map itself, e.g it will not insert a key
@@ -24,232 +238,1145 @@ namespace CSTM {
 	 *		hash flooding attacks. Incorporating a random seed *can* also result in a more uniform distribution of hash
 	 *		values across the map.
 	 *		This decision was primarily inspired by Swifts' Hashable implementation.
+	 *
+	 *	4. Elements are stored in one flat allocation using open addressing (inspired by Abseils' Swiss tables),
+	 *		inserting an element never allocates unless the map has to grow. Each slot has a control byte which
+	 *		lets us reject almost every non-matching slot without ever touching the key itself.
+	 *
+	 *	5. The bucket count is always a power of two, so finding a bucket is a mask instead of a division.
+	 *		Every hash is passed through hash_mix first to make sure weak hashes can't cluster in the lower bits,
+	 *		unless the hasher guarantees that its results are well distributed already (see AvalanchingHasher).
+	 *
+	 *	6. Iteration (iterators, for_each, keys and values) walks the buckets in memory order, the order of elements
+	 *		is unspecified and any insertion can invalidate iterators. Dereferencing a mutable iterator produces a pair
+	 *		of references where the key is always const, since modifying it would corrupt the map.
+	 *
+	 *	7. If CacheHashes is true the full hash of every element is stored next to it. Growing the map never has to
+	 *		hash a key again, and lookups only compare keys whose full hash matches. This is the default for any key
+	 *		that isn't a scalar, since those are usually expensive to hash and compare (e.g strings).
+	 *
+	 *	8. Memory comes from Alloc (see Allocator.hpp), e.g an ArenaAllocator for maps that only live as long as the
+	 *		arena does. The allocator is copied along with the map.
 	 */
 
-	template<typename Key, typename Value, Hasher<Key> Hash>
-	class BasicHashMap
-	{
-		using BucketType = std::list<std::pair<Key, Value>>;
-		using BucketList = std::unique_ptr<BucketType[]>;
+	template<
+		typename Key, typename Value, Hasher<Key> Hash,
+		bool CacheHashes = CacheHashesByDefault<Key>,
+		Allocator Alloc = DefaultAllocator
+	>
+	class BasicHashMap
+	{
+		using Slot = std::pair<Key, Value>;
+
+		// Lookups accept any type that the (transparent) hasher can hash, and that the key can be compared to.
+		// NOTE(Peter): It's up to the hasher to make sure that equal values hash the same regardless of their type
+		template<typename K>
+		static constexpr bool IsTransparentKey = TransparentHasher<Hash> && !std::same_as<K, Key> &&
+			requires(const Hash& hasher, const Key& key, const K& other)
+			{
+				{ hasher(other) } -> std::same_as<size_t>;
+				{ key == other } -> std::convertible_to<bool>;
+			};
+
+		template<bool IsConst>
+		class BasicIterator
+		{
+			using SlotPointer = std::conditional_t<IsConst, const Slot*, Slot*>;
+			using ValueReference = std::conditional_t<IsConst, const Value&, Value&>;
+
+		public:
+			using iterator_concept = std::forward_iterator_tag;
+			using value_type = std::pair<Key, Value>;
+			using difference_type = std::ptrdiff_t;
+			using reference = std::conditional_t<IsConst, const Slot&, std::pair<const Key&, Value&>>;
+
+			BasicIterator() noexcept = default;
+
+			operator BasicIterator<true>() const noexcept requires(!IsConst)
+			{
+				return BasicIterator<true>{ m_control, m_end, m_slot };
+			}
+
+			[[nodiscard]]
+			reference operator*() const noexcept
+			{
+				if constexpr (IsConst)
+				{
+					return *m_slot;
+				}
+				else
+				{
+					return { m_slot->first, m_slot->second };
+				}
+			}
+
+			[[nodiscard]]
+			const Key& key() const noexcept { return m_slot->first; }
+
+			[[nodiscard]]
+			ValueReference value() const noexcept { return m_slot->second; }
+
+			BasicIterator& operator++() noexcept
+			{
+				advance(1);
+				skip_free_buckets();
+				return *this;
+			}
+
+			BasicIterator operator++(int) noexcept
+			{
+				BasicIterator it = *this;
+				++*this;
+				return it;
+			}
+
+			[[nodiscard]]
+			bool operator==(const BasicIterator& other) const noexcept { return m_control == other.m_control; }
+
+		private:
+			BasicIterator(const int8_t* control, const int8_t* end, SlotPointer slot) noexcept
+				: m_control(control), m_end(end), m_slot(slot)
+			{
+			}
+
+			void advance(const size_t count) noexcept
+			{
+				m_control += count;
+				m_slot += count;
+			}
+
+			// Skips a whole group of free buckets at a time
+			void skip_free_buckets() noexcept
+			{
+				while (m_control < m_end)
+				{
+					if (const auto fullBuckets = ControlGroup(m_control).match_full())
+					{
+						advance(fullBuckets.trailing_zeros());
+						break;
+					}
+
+					advance(ControlGroup::Width);
+				}
+
+				// NOTE(Peter): The last group reads the cloned control bytes, which can take us past the end
+				if (m_control > m_end)
+				{
+					m_slot -= m_control - m_end;
+					m_control = m_end;
+				}
+			}
+
+		private:
+			const int8_t* m_control = nullptr;
+			const int8_t* m_end = nullptr;
+			SlotPointer m_slot = nullptr;
+
+			template<bool>
+			friend class BasicIterator;
+
+			friend class BasicHashMap;
+		};
+
+	public:
+		using Iterator = BasicIterator<false>;
+		using ConstIterator = BasicIterator<true>;
+
+	public:
+		static constexpr size_t InitialBucketCount = 16;
+
+		// NOTE(Peter): Open addressing needs at least one empty slot to terminate a probe, 7/8 is what Abseil uses
+		static constexpr double MaxLoadFactor = 0.875;
+
+		BasicHashMap()
+			requires std::default_initializable<Alloc>
+			: BasicHashMap(InitialBucketCount)
+		{}
+
+		explicit BasicHashMap(Alloc allocator)
+			: BasicHashMap(InitialBucketCount, std::move(allocator))
+		{}
+
+		// NOTE(Peter): bucketCount is rounded up to a power of two, use reserve to size the map for a number of elements
+		explicit BasicHashMap(size_t bucketCount, Alloc allocator = Alloc())
+			: m_allocator(std::move(allocator))
+		{
+			allocate_buckets(bucketCount);
+		}
+
+		BasicHashMap(const BasicHashMap& other) noexcept
+			: m_allocator(other.m_allocator)
+		{
+			copy_construct(other);
+		}
+
+		BasicHashMap(BasicHashMap&& other) noexcept
+			: m_allocator(other.m_allocator)
+		{
+			move_construct(std::forward<BasicHashMap>(other));
+		}
+
+		BasicHashMap(std::initializer_list<std::pair<Key, Value>> elements)
+			: BasicHashMap(bucket_count_for(elements.size()))
+		{
+			for (const auto& kv : elements)
+			{
+				insert(kv.first, kv.second);
+			}
+		}
+
+		// Builds a map from a range of key value pairs, see UniqueKeysTag
+		template<std::ranges::sized_range Range>
+			requires std::constructible_from<std::pair<Key, Value>, std::ranges::range_reference_t<Range>>
+		[[nodiscard]]
+		static BasicHashMap from_unique(Range&& range)
+		{
+			BasicHashMap map(bucket_count_for(std::ranges::size(range)));
+			map.insert_range(UniqueKeys, std::forward<Range>(range));
+			return map;
+		}
+
+		~BasicHashMap()
+		{
+			destroy();
+		}
+
+		BasicHashMap& operator=(const BasicHashMap& other) noexcept
+		{
+			if (this == &other)
+			{
+				return *this;
+			}
+
+			destroy();
+			copy_construct(other);
+			return *this;
+		}
+
+		BasicHashMap& operator=(BasicHashMap&& other) noexcept
+		{
+			if (this == &other)
+			{
+				return *this;
+			}
+
+			destroy();
+			move_construct(std::forward<BasicHashMap>(other));
+			return *this;
+		}
+
+		void insert(const Key& key, const Value& value)
+		{
+			insert_with_hash(hash_key(key), key, value);
+		}
+
+		/*
+		 * Same as insert, but takes the hash of key instead of computing it. Every *_with_hash function works like this,
+		 * they're meant for callers that already had to hash the key, e.g ConcurrentHashMap which picks a shard by it.
+		 * NOTE(Peter): hash must be mixed_hash(Hash{}, key), otherwise keys end up in (or are looked for in) the wrong place
+		 */
+		void insert_with_hash(const size_t hash, const Key& key, const Value& value)
+		{
+			const auto position = find_or_prepare_insert(key, hash);
+
+			if (position.found)
+			{
+				throw std::runtime_error("Key already present in map!");
+			}
+
+			construct_in_bucket(position.bucket_index, position.hash, key, value);
+		}
+
+		// Constructs the value from args if key isn't present in the map yet, otherwise args are left untouched
+		template<typename... Args>
+			requires std::constructible_from<Value, Args...>
+		Result<Value&, HashMapError> try_emplace(const Key& key, Args&&... args)
+		{
+			return try_emplace_impl(hash_key(key), key, std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+			requires std::constructible_from<Value, Args...>
+		Result<Value&, HashMapError> try_emplace(Key&& key, Args&&... args)
+		{
+			return try_emplace_impl(hash_key(key), std::move(key), std::forward<Args>(args)...);
+		}
+
+		template<typename K, typename... Args>
+			requires std::same_as<std::remove_cvref_t<K>, Key> && std::constructible_from<Value, Args...>
+		Result<Value&, HashMapError> try_emplace_with_hash(const size_t hash, K&& key, Args&&... args)
+		{
+			return try_emplace_impl(hash, std::forward<K>(key), std::forward<Args>(args)...);
+		}
+
+		/*
+		 * Constructs a key value pair from args and inserts it if the key isn't present in the map yet.
+		 * NOTE(Peter): The pair has to be constructed before we know the key, so prefer try_emplace if the key is at hand.
+		 */
+		template<typename... Args>
+			requires std::constructible_from<std::pair<Key, Value>, Args...>
+		Result<Value&, HashMapError> emplace(Args&&... args)
+		{
+			std::pair<Key, Value> kv(std::forward<Args>(args)...);
+			const auto position = find_or_prepare_insert(kv.first, hash_key(kv.first));
+
+			if (position.found)
+			{
+				return HashMapError::KeyAlreadyPresent;
+			}
+
+			construct_in_bucket(position.bucket_index, position.hash, std::move(kv));
+			return m_slots[position.bucket_index].second;
+		}
+
+		// Inserts value if key isn't present in the map yet, otherwise assigns value to the existing value
+		template<typename V>
+			requires std::assignable_from<Value&, V&&>
+		Value& insert_or_assign(const Key& key, V&& value)
+		{
+			return insert_or_assign_impl(hash_key(key), key, std::forward<V>(value));
+		}
+
+		template<typename V>
+			requires std::assignable_from<Value&, V&&>
+		Value& insert_or_assign(Key&& key, V&& value)
+		{
+			return insert_or_assign_impl(hash_key(key), std::move(key), std::forward<V>(value));
+		}
+
+		template<typename K, typename V>
+			requires std::same_as<std::remove_cvref_t<K>, Key> && std::assignable_from<Value&, V&&>
+		Value& insert_or_assign_with_hash(const size_t hash, K&& key, V&& value)
+		{
+			return insert_or_assign_impl(hash, std::forward<K>(key), std::forward<V>(value));
+		}
+
+		// Inserts every key value pair in range, throws if any of the keys are already present in the map
+		template<std::ranges::input_range Range>
+			requires std::constructible_from<std::pair<Key, Value>, std::ranges::range_reference_t<Range>>
+		void insert_range(Range&& range)
+		{
+			if constexpr (std::ranges::sized_range<Range>)
+			{
+				reserve(m_element_count + std::ranges::size(range));
+			}
+
+			for (auto&& kv : range)
+			{
+				insert(kv.first, kv.second);
+			}
+		}
+
+		// Inserts every key value pair in range without checking for duplicates, see UniqueKeysTag
+		template<std::ranges::sized_range Range>
+			requires std::constructible_from<std::pair<Key, Value>, std::ranges::range_reference_t<Range>>
+		void insert_range(UniqueKeysTag, Range&& range)
+		{
+			// NOTE(Peter): Reserving up front guarantees that the loop below never has to rehash
+			reserve(m_element_count + std::ranges::size(range));
+
+			for (auto&& kv : range)
+			{
+				const size_t hash = hash_key(kv.first);
+				construct_in_bucket(find_free_bucket(hash), hash, std::forward<decltype(kv)>(kv));
+			}
+		}
+
+		// Makes sure that elementCount elements can be present in the map without it having to rehash
+		void reserve(size_t elementCount)
+		{
+			if (elementCount + m_deleted_count <= max_element_count(m_bucket_count))
+			{
+				return;
+			}
+
+			force_rehash(bucket_count_for(elementCount));
+		}
+
+		void remove(const Key& key)
+		{
+			remove_impl(key);
+		}
+
+		template<typename K>
+			requires IsTransparentKey<K>
+		void remove(const K& key)
+		{
+			remove_impl(key);
+		}
+
+		// Same as remove, but returns false instead of throwing if key isn't present
+		bool try_remove(const Key& key)
+		{
+			return try_remove_impl(key);
+		}
+
+		template<typename K>
+			requires IsTransparentKey<K>
+		bool try_remove(const K& key)
+		{
+			return try_remove_impl(key);
+		}
+
+		bool try_remove_with_hash(const size_t hash, const Key& key)
+		{
+			return try_remove_bucket(find_key_bucket(key, hash));
+		}
+
+		template<typename K>
+			requires IsTransparentKey<K>
+		bool try_remove_with_hash(const size_t hash, const K& key)
+		{
+			return try_remove_bucket(find_key_bucket(key, hash));
+		}
+
+		[[nodiscard]]
+		bool contains(const Key& key) const noexcept
+		{
+			return find_key_bucket(key).has_value();
+		}
+
+		template<typename K>
+			requires IsTransparentKey<K>
+		[[nodiscard]]
+		bool contains(const K& key) const noexcept
+		{
+			return find_key_bucket(key).has_value();
+		}
+
+		[[nodiscard]]
+		bool contains_with_hash(const size_t hash, const Key& key) const noexcept
+		{
+			return find_key_bucket(key, hash).has_value();
+		}
+
+		template<typename K>
+			requires IsTransparentKey<K>
+		[[nodiscard]]
+		bool contains_with_hash(const size_t hash, const K& key) const noexcept
+		{
+			return find_key_bucket(key, hash).has_value();
+		}
+
+		// Returns the value of key (which is const if the map is), or nullptr if the map doesn't contain key
+		[[nodiscard]]
+		auto* find(this auto&& self, const Key& key) noexcept
+		{
+			using Self = decltype(self);
+
+			const auto bucketIndex = self.find_key_bucket(key);
+			return bucketIndex.has_value() ? std::addressof(std::forward_like<Self>(self.m_slots[bucketIndex.value()].second)) : nullptr;
+		}
+
+		template<typename K>
+			requires IsTransparentKey<K>
+		[[nodiscard]]
+		auto* find(this auto&& self, const K& key) noexcept
+		{
+			using Self = decltype(self);
+
+			const auto bucketIndex = self.find_key_bucket(key);
+			return bucketIndex.has_value() ? std::addressof(std::forward_like<Self>(self.m_slots[bucketIndex.value()].second)) : nullptr;
+		}
+
+		[[nodiscard]]
+		auto* find_with_hash(this auto&& self, const size_t hash, const Key& key) noexcept
+		{
+			using Self = decltype(self);
+
+			const auto bucketIndex = self.find_key_bucket(key, hash);
+			return bucketIndex.has_value() ? std::addressof(std::forward_like<Self>(self.m_slots[bucketIndex.value()].second)) : nullptr;
+		}
+
+		template<typename K>
+			requires IsTransparentKey<K>
+		[[nodiscard]]
+		auto* find_with_hash(this auto&& self, const size_t hash, const K& key) noexcept
+		{
+			using Self = decltype(self);
+
+			const auto bucketIndex = self.find_key_bucket(key, hash);
+			return bucketIndex.has_value() ? std::addressof(std::forward_like<Self>(self.m_slots[bucketIndex.value()].second)) : nullptr;
+		}
+
+		[[nodiscard]]
+		size_t element_count() const noexcept { return m_element_count; }
+
+		[[nodiscard]]
+		size_t bucket_count() const noexcept { return m_bucket_count; }
+
+		[[nodiscard]]
+		bool is_empty() const noexcept { return m_element_count == 0; }
+
+		void clear()
+		{
+			// NOTE(Peter): Moved from maps don't have any storage
+			if (m_control == nullptr)
+			{
+				return;
+			}
+
+			for (size_t i = 0; i < m_bucket_count; i++)
+			{
+				if (HashControl::is_full(m_control[i]))
+				{
+					std::destroy_at(m_slots + i);
+				}
+			}
+
+			std::fill_n(m_control, m_bucket_count + ClonedControlCount, HashControl::Empty);
+			m_element_count = 0;
+			m_deleted_count = 0;
+		}
+
+		[[nodiscard]]
+		Iterator begin() noexcept { return make_begin<Iterator>(); }
+
+		[[nodiscard]]
+		ConstIterator begin() const noexcept { return make_begin<ConstIterator>(); }
+
+		[[nodiscard]]
+		Iterator end() noexcept { return Iterator{ m_control + m_bucket_count, m_control + m_bucket_count, m_slots + m_bucket_count }; }
+
+		[[nodiscard]]
+		ConstIterator end() const noexcept { return ConstIterator{ m_control + m_bucket_count, m_control + m_bucket_count, m_slots + m_bucket_count }; }
+
+		// Range of every key in the map
+		[[nodiscard]]
+		auto keys() const noexcept
+		{
+			return std::views::transform(*this, [](const auto& kv) -> const Key& { return kv.first; });
+		}
+
+		// Range of every value in the map, the values are only mutable if the map is
+		[[nodiscard]]
+		auto values(this auto&& self) noexcept
+		{
+			using Self = decltype(self);
+			return std::views::transform(std::forward<Self>(self), [](auto&& kv) -> decltype(auto) { return (kv.second); });
+		}
+
+		/*
+		 * Calls func with every key and value in the map, which is cheaper than using iterators since we can process
+		 * a whole group of buckets at a time. Returning IterAction::Break from func stops the iteration.
+		 */
+		template<typename Func>
+		void for_each(this auto&& self, Func&& func)
+		{
+			using Self = decltype(self);
+			using ReturnType = std::invoke_result_t<Func, const Key&, decltype(std::forward_like<Self>(std::declval<Value&>()))>;
 
-	public:
-		static constexpr size_t InitialBucketCount = 10;
-		static constexpr double MaxLoadFactor = 1.0;
+			// NOTE(Peter): The bucket count is a multiple of the group width, so we never have to look at cloned bytes
+			for (size_t groupIndex = 0; groupIndex < self.m_bucket_count; groupIndex += ControlGroup::Width)
+			{
+				for (const uint32_t offset : ControlGroup(self.m_control + groupIndex).match_full())
+				{
+					auto& slot = self.m_slots[groupIndex + offset];
 
-		BasicHashMap()
-			: BasicHashMap(InitialBucketCount)
-		{}
+					if constexpr (std::same_as<ReturnType, IterAction>)
+					{
+						if (func(std::as_const(slot.first), std::forward_like<Self>(slot.second)) == IterAction::Break)
+						{
+							return;
+						}
+					}
+					else
+					{
+						func(std::as_const(slot.first), std::forward_like<Self>(slot.second));
+					}
+				}
+			}
+		}
 
-		explicit BasicHashMap(size_t bucketCount)
-			: m_buckets(new BucketType[bucketCount]), m_element_count(0), m_bucket_count(bucketCount)
+		[[nodiscard]]
+		decltype(auto) operator[](this auto&& self, const Key& key)
 		{
+			using Self = decltype(self);
+			return std::forward<Self>(self).at(key);
 		}
 
-		BasicHashMap(const BasicHashMap& other) noexcept
+		template<typename K>
+			requires IsTransparentKey<K>
+		[[nodiscard]]
+		decltype(auto) operator[](this auto&& self, const K& key)
 		{
-			copy_construct(other);
+			using Self = decltype(self);
+			return std::forward<Self>(self).at(key);
 		}
 
-		BasicHashMap(BasicHashMap&& other) noexcept
+		[[nodiscard]]
+		decltype(auto) at(this auto&& self, const Key& key)
 		{
-			move_construct(std::forward<BasicHashMap>(other));
+			using Self = decltype(self);
+
+			size_t bucketIndex = self
+				.find_key_bucket(key)
+				.template throw_on_error<std::runtime_error>("Key not found!")
+				.value();
+
+			return std::forward_like<Self>(self.m_slots[bucketIndex].second);
 		}
 
-		// FIXME(Peter): This constructor causes strange behavior, probably due to being in a weird state
-		BasicHashMap(std::initializer_list<std::pair<Key, Value>> elements)
-			: BasicHashMap()
+		template<typename K>
+			requires IsTransparentKey<K>
+		[[nodiscard]]
+		decltype(auto) at(this auto&& self, const K& key)
 		{
-			for (const auto& kv : elements)
-			{
-				insert(kv.first, kv.second);
-			}
+			using Self = decltype(self);
+
+			size_t bucketIndex = self
+				.find_key_bucket(key)
+				.template throw_on_error<std::runtime_error>("Key not found!")
+				.value();
 
-			force_rehash(m_bucket_count);
+			return std::forward_like<Self>(self.m_slots[bucketIndex].second);
 		}
 
-		~BasicHashMap() = default;
+	private:
+		template<typename K>
+		void remove_impl(const K& key)
+		{
+			size_t bucketIndex = find_key_bucket(key)
+				.template throw_on_error<std::runtime_error>("Key not present in map!")
+				.value();
+
+			remove_bucket(bucketIndex);
+		}
 
-		BasicHashMap& operator=(const BasicHashMap& other) noexcept
+		template<typename K>
+		bool try_remove_impl(const K& key)
 		{
-			copy_construct(other);
-			return *this;
+			return try_remove_bucket(find_key_bucket(key));
 		}
 
-		BasicHashMap& operator=(BasicHashMap&& other) noexcept
+		bool try_remove_bucket(const Result<size_t, NullType>& bucketIndex)
 		{
-			move_construct(std::forward<BasicHashMap>(other));
-			return *this;
+			if (!bucketIndex.has_value())
+			{
+				return false;
+			}
+
+			remove_bucket(bucketIndex.value());
+			return true;
 		}
 
-		void insert(const Key& key, const Value& value)
+		void remove_bucket(const size_t bucketIndex)
 		{
-			find_key_bucket(key)
-				.template throw_on_value<std::runtime_error>("Key already present in map!");
+			std::destroy_at(m_slots + bucketIndex);
+			m_element_count--;
 
-			try_rehash();
+			// NOTE(Peter): If no group containing this bucket has ever been without a free bucket, no probe can have
+			//				passed over it, which means that we can mark it as empty again instead of leaving a tombstone
+			const ControlGroup groupBefore(m_control + ((bucketIndex - ControlGroup::Width) & bucket_mask()));
+			const auto emptyBefore = groupBefore.match_empty();
+			const auto emptyAfter = ControlGroup(m_control + bucketIndex).match_empty();
 
-			size_t bucketIndex = get_bucket_index(key);
-			m_buckets[bucketIndex].emplace_back(std::make_pair(key, value));
-			m_element_count++;
+			if (emptyBefore && emptyAfter && emptyAfter.trailing_zeros() + emptyBefore.leading_zeros() < ControlGroup::Width)
+			{
+				set_control(bucketIndex, HashControl::Empty);
+				return;
+			}
+
+			set_control(bucketIndex, HashControl::Deleted);
+			m_deleted_count++;
 		}
 
-		void remove(const Key& key)
+		// NOTE(Peter): The first Width - 1 control bytes are mirrored after the last bucket, that way a group
+		//				can always be loaded with a single unaligned load, even when it wraps around
+		static constexpr size_t ClonedControlCount = ControlGroup::Width - 1;
+
+		[[nodiscard]]
+		static constexpr size_t h1(const size_t hash) noexcept { return hash >> 7; }
+
+		[[nodiscard]]
+		static constexpr int8_t h2(const size_t hash) noexcept { return static_cast<int8_t>(hash & 0x7F); }
+
+		// NOTE(Peter): Integer version of bucketCount * MaxLoadFactor, exact since the bucket count is a power of two
+		[[nodiscard]]
+		static constexpr size_t max_element_count(const size_t bucketCount) noexcept
 		{
-			auto it = find_key_bucket(key)
-				.template throw_on_error<std::runtime_error>("Key not present in map!")
-				.value();
+			return bucketCount - bucketCount / 8;
+		}
 
-			it.first.erase(it.second);
-			m_element_count--;
+		template<typename It>
+		[[nodiscard]]
+		It make_begin() const noexcept
+		{
+			It it{ m_control, m_control + m_bucket_count, m_slots };
+			it.skip_free_buckets();
+			return it;
 		}
 
+		// Smallest bucket count that can hold elementCount elements without exceeding the max load factor
 		[[nodiscard]]
-		bool contains(const Key& key) const noexcept
+		static constexpr size_t bucket_count_for(const size_t elementCount) noexcept
 		{
-			return find_key_bucket(key).has_value();
+			return std::bit_ceil(std::max((elementCount * 8 + 6) / 7, ControlGroup::Width));
 		}
 
+		// Triangular probing over groups, this visits every group exactly once when the bucket count is a power of two
+		struct ProbeSequence
+		{
+			size_t group_index;
+			size_t mask;
+			size_t stride = 0;
+
+			void next() noexcept
+			{
+				stride += ControlGroup::Width;
+				group_index = (group_index + stride) & mask;
+			}
+		};
+
 		[[nodiscard]]
-		size_t element_count() const noexcept { return m_element_count; }
+		size_t bucket_mask() const noexcept { return m_bucket_count - 1; }
 
 		[[nodiscard]]
-		size_t bucket_count() const noexcept { return m_bucket_count; }
+		ProbeSequence probe(const size_t hash) const noexcept
+		{
+			return ProbeSequence{ h1(hash) & bucket_mask(), bucket_mask() };
+		}
 
+		template<typename K>
 		[[nodiscard]]
-		bool is_empty() const noexcept { return m_element_count == 0; }
+		size_t hash_key(const K& key) const noexcept
+		{
+			return mixed_hash(m_hasher, key);
+		}
 
-		void clear()
+		template<typename K>
+		[[nodiscard]]
+		Result<size_t, NullType> find_key_bucket(const K& key) const noexcept
 		{
-			for (size_t i = 0; i < m_bucket_count; i++)
+			if (m_element_count == 0)
 			{
-				m_buckets[i].clear();
+				return Null;
 			}
 
-			m_element_count = 0;
+			return find_key_bucket(key, hash_key(key));
 		}
 
+		template<typename K>
 		[[nodiscard]]
-		decltype(auto) operator[](this auto&& self, const Key& key)
+		Result<size_t, NullType> find_key_bucket(const K& key, const size_t hash) const noexcept
 		{
-			using Self = decltype(self);
-			return std::forward<Self>(self).at(key);
+			const int8_t tag = h2(hash);
+
+			for (ProbeSequence sequence = probe(hash); sequence.stride < m_bucket_count; sequence.next())
+			{
+				const ControlGroup group(m_control + sequence.group_index);
+
+				for (const uint32_t offset : group.match(tag))
+				{
+					const size_t bucketIndex = (sequence.group_index + offset) & bucket_mask();
+
+					if constexpr (CacheHashes)
+					{
+						// NOTE(Peter): The tag only rejects 127 out of 128 mismatches, the full hash rejects the rest
+						if (cached_hashes()[bucketIndex] != hash)
+						{
+							continue;
+						}
+					}
+
+					if (m_slots[bucketIndex].first == key)
+					{
+						return bucketIndex;
+					}
+				}
+
+				// An empty bucket terminates the probe, the key would've been inserted there
+				if (group.match_empty())
+				{
+					break;
+				}
+			}
+
+			return Null;
 		}
 
+		struct InsertPosition
+		{
+			size_t bucket_index;
+			size_t hash;
+
+			// If true bucket_index refers to the existing element with the same key
+			bool found;
+		};
+
+		// Looks up key and if it's missing makes room for it, only hashing the key once
 		[[nodiscard]]
-		decltype(auto) at(this auto&& self, const Key& key)
+		InsertPosition find_or_prepare_insert(const Key& key, const size_t hash)
 		{
-			using Self = decltype(self);
+			if (const auto bucketIndex = find_key_bucket(key, hash); bucketIndex.has_value())
+			{
+				return { bucketIndex.value(), hash, true };
+			}
 
-			auto it = std::forward<Self>(self)
-				.find_key_bucket(key)
-				.template throw_on_error<std::runtime_error>("Key not found!")
-				.value();
+			try_rehash();
+			return { find_free_bucket(hash), hash, false };
+		}
 
-			return std::forward_like<Self>(it.second->second);
+		template<typename K, typename... Args>
+		Result<Value&, HashMapError> try_emplace_impl(const size_t hash, K&& key, Args&&... args)
+		{
+			const auto position = find_or_prepare_insert(key, hash);
+
+			if (position.found)
+			{
+				return HashMapError::KeyAlreadyPresent;
+			}
+
+			construct_in_bucket(
+				position.bucket_index, position.hash, std::piecewise_construct,
+				std::forward_as_tuple(std::forward<K>(key)),
+				std::forward_as_tuple(std::forward<Args>(args)...)
+			);
+
+			return m_slots[position.bucket_index].second;
 		}
 
-	private:
-		decltype(auto) find_key_bucket(this auto&& self, const Key& key) noexcept
+		template<typename K, typename V>
+		Value& insert_or_assign_impl(const size_t hash, K&& key, V&& value)
 		{
-			using Self = decltype(self);
+			const auto position = find_or_prepare_insert(key, hash);
+
+			if (position.found)
+			{
+				m_slots[position.bucket_index].second = std::forward<V>(value);
+			}
+			else
+			{
+				construct_in_bucket(position.bucket_index, position.hash, std::forward<K>(key), std::forward<V>(value));
+			}
+
+			return m_slots[position.bucket_index].second;
+		}
+
+		// Returns the first empty or deleted bucket in the probe sequence of hash
+		[[nodiscard]]
+		size_t find_free_bucket(const size_t hash) const noexcept
+		{
+			for (ProbeSequence sequence = probe(hash); ; sequence.next())
+			{
+				const auto freeBuckets = ControlGroup(m_control + sequence.group_index).match_free();
+
+				if (freeBuckets)
+				{
+					return (sequence.group_index + freeBuckets.trailing_zeros()) & bucket_mask();
+				}
+			}
+		}
 
-			size_t bucketIndex = std::forward<Self>(self).get_bucket_index(key);
-			auto&& bucket = std::forward<Self>(self).m_buckets[bucketIndex];
+		void set_control(const size_t bucketIndex, const int8_t control) noexcept
+		{
+			// NOTE(Peter): Writes the cloned control byte for the first ClonedControlCount buckets,
+			//				for every other bucket this simply writes the same byte twice (which avoids a branch)
+			m_control[bucketIndex] = control;
+			m_control[((bucketIndex - ClonedControlCount) & bucket_mask()) + ClonedControlCount] = control;
+		}
+
+		// Marks bucketIndex as containing an element with the given hash
+		void set_full(const size_t bucketIndex, const size_t hash) noexcept
+		{
+			set_control(bucketIndex, h2(hash));
 
-			using BucketType = decltype(bucket);
+			if constexpr (CacheHashes)
+			{
+				cached_hashes()[bucketIndex] = hash;
+			}
+		}
 
-			auto it = std::ranges::find_if(std::forward<BucketType>(bucket), [&key](const auto& kv)
+		// The hash of the element in bucketIndex, without hashing the key again if the hash is cached
+		[[nodiscard]]
+		size_t hash_of(const size_t bucketIndex) const noexcept
+		{
+			if constexpr (CacheHashes)
+			{
+				return cached_hashes()[bucketIndex];
+			}
+			else
 			{
-				return kv.first == key;
-			});
+				return hash_key(m_slots[bucketIndex].first);
+			}
+		}
 
-			using BucketIt = std::pair<BucketType&, decltype(it)>;
+		template<typename... Args>
+		void construct_in_bucket(size_t bucketIndex, size_t hash, Args&&... args)
+		{
+			std::construct_at(m_slots + bucketIndex, std::forward<Args>(args)...);
 
-			if (it == bucket.end())
+			if (m_control[bucketIndex] == HashControl::Deleted)
 			{
-				return Result<BucketIt, NullType>{ Null };
+				m_deleted_count--;
 			}
 
-			return Result<BucketIt, NullType>{ BucketIt{ std::forward<BucketType>(bucket), it } };
+			set_full(bucketIndex, hash);
+			m_element_count++;
 		}
 
 		void try_rehash()
 		{
-			if (static_cast<double>(m_element_count) / static_cast<double>(m_bucket_count) <= MaxLoadFactor)
+			// NOTE(Peter): Deleted buckets never terminate a probe, so they have to count towards the load factor
+			if (m_element_count + m_deleted_count + 1 <= max_element_count(m_bucket_count))
+			{
+				return;
+			}
+
+			// If most of the used buckets are tombstones growing would be a waste, reclaim them instead
+			if (m_bucket_count > ControlGroup::Width && m_element_count * 32 <= m_bucket_count * 25)
 			{
+				rehash_in_place();
 				return;
 			}
 
-			// TODO(Peter): Implement more optimal rules for bucket growth
-			//				MSVC will try to grow by x8 initally, unsure what libstdc++ does
-			force_rehash(m_bucket_count * 2 + 1);
+			force_rehash(std::max(m_bucket_count * 2, InitialBucketCount));
 		}
 
 		void force_rehash(size_t bucketCount)
 		{
-			BucketList buckets(new BucketType[bucketCount]);
+			Slot* slots = m_slots;
+			const int8_t* control = m_control;
+			const size_t oldBucketCount = m_bucket_count;
+			const size_t elementCount = m_element_count;
+			const size_t* hashes = CacheHashes ? cached_hashes() : nullptr;
+
+			allocate_buckets(bucketCount);
+
+			// NOTE(Peter): The new buckets contain neither duplicates nor tombstones, so every element can be
+			//				relocated straight into the first free bucket without any key comparisons
+			for (size_t i = 0; i < oldBucketCount; i++)
+			{
+				if (!HashControl::is_full(control[i]))
+				{
+					continue;
+				}
+
+				const size_t hash = CacheHashes ? hashes[i] : hash_key(slots[i].first);
+				const size_t bucketIndex = find_free_bucket(hash);
+				relocate(m_slots + bucketIndex, slots + i);
+				set_full(bucketIndex, hash);
+			}
+
+			m_element_count = elementCount;
+			deallocate_buckets(slots, oldBucketCount);
+		}
+
+		/*
+		 * Removes every tombstone without allocating (based on Abseils' DropDeletesWithoutResize):
+		 *	1. Mark every full bucket as deleted and every other bucket as empty
+		 *	2. Walk the "deleted" buckets, moving each element to the first free bucket of its probe sequence.
+		 *		If that bucket still holds an element that hasn't been visited yet the two are swapped
+		 *		and the current bucket is processed again.
+		 */
+		void rehash_in_place()
+		{
+			for (size_t i = 0; i < m_bucket_count; i++)
+			{
+				m_control[i] = HashControl::is_full(m_control[i]) ? HashControl::Deleted : HashControl::Empty;
+			}
+
+			std::copy_n(m_control, ClonedControlCount, m_control + m_bucket_count);
+
+			alignas(Slot) byte swapStorage[sizeof(Slot)];
+			Slot* swapSlot = reinterpret_cast<Slot*>(swapStorage);
 
 			for (size_t i = 0; i < m_bucket_count; i++)
 			{
-				for (const auto& pair : m_buckets[i])
+				if (m_control[i] != HashControl::Deleted)
+				{
+					continue;
+				}
+
+				const size_t hash = hash_of(i);
+				const size_t probeStart = probe(hash).group_index;
+				const size_t bucketIndex = find_free_bucket(hash);
+
+				auto probe_group = [&](const size_t index)
+				{
+					return ((index - probeStart) & bucket_mask()) / ControlGroup::Width;
+				};
+
+				// Already in the best group it can be in, leave it be
+				if (probe_group(i) == probe_group(bucketIndex))
+				{
+					set_control(i, h2(hash));
+					continue;
+				}
+
+				if (m_control[bucketIndex] == HashControl::Empty)
+				{
+					relocate(m_slots + bucketIndex, m_slots + i);
+					set_full(bucketIndex, hash);
+					set_control(i, HashControl::Empty);
+					continue;
+				}
+
+				relocate(swapSlot, m_slots + bucketIndex);
+				relocate(m_slots + bucketIndex, m_slots + i);
+				relocate(m_slots + i, swapSlot);
+
+				if constexpr (CacheHashes)
 				{
-					size_t bucketIndex = compute_bucket_index(bucketCount, pair.first);
-					buckets[bucketIndex].emplace_back(pair);
+					cached_hashes()[i] = cached_hashes()[bucketIndex];
 				}
+
+				set_full(bucketIndex, hash);
+				i--;
+			}
+
+			m_deleted_count = 0;
+		}
+
+		// Moves the element in src into the uninitialized slot dst, leaving src uninitialized
+		static void relocate(Slot* dst, Slot* src) noexcept
+		{
+			// NOTE(Peter): Trivially copyable keys and values can be moved around as plain bytes
+			if constexpr (std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>)
+			{
+				std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(Slot));
+			}
+			else
+			{
+				std::construct_at(dst, std::move(*src));
+				std::destroy_at(src);
+			}
+		}
+
+		static constexpr size_t AllocationAlignment = std::max(alignof(Slot), CacheHashes ? alignof(size_t) : 1);
+
+		// Offset of the control bytes from the start of the allocation, the cached hashes (if any) end right before them
+		[[nodiscard]]
+		static constexpr size_t control_offset(const size_t bucketCount) noexcept
+		{
+			size_t offset = bucketCount * sizeof(Slot);
+
+			if constexpr (CacheHashes)
+			{
+				offset = (offset + alignof(size_t) - 1) & ~(alignof(size_t) - 1);
+				offset += bucketCount * sizeof(size_t);
 			}
 
-			m_buckets = CSTM_Move(buckets);
+			return offset;
+		}
+
+		[[nodiscard]]
+		size_t* cached_hashes() const noexcept
+		{
+			return reinterpret_cast<size_t*>(m_control) - m_bucket_count;
+		}
+
+		void allocate_buckets(size_t bucketCount)
+		{
+			// Every group has to consist of distinct buckets
+			bucketCount = std::bit_ceil(std::max(bucketCount, ControlGroup::Width));
+
+			const size_t controlCount = bucketCount + ClonedControlCount;
+			const size_t controlOffset = control_offset(bucketCount);
+
+			// NOTE(Peter): Slots, cached hashes and control bytes share a single allocation, in order of alignment
+			void* memory = m_allocator.allocate(controlOffset + controlCount, AllocationAlignment);
+
+			m_slots = static_cast<Slot*>(memory);
+			m_control = static_cast<int8_t*>(memory) + controlOffset;
+			std::fill_n(m_control, controlCount, HashControl::Empty);
+
 			m_bucket_count = bucketCount;
+			m_element_count = 0;
+			m_deleted_count = 0;
 		}
 
-		size_t get_bucket_index(const Key& key) const noexcept
+		void deallocate_buckets(Slot* slots, const size_t bucketCount) noexcept
 		{
-			return compute_bucket_index(m_bucket_count, key);
+			const size_t byteCount = control_offset(bucketCount) + bucketCount + ClonedControlCount;
+			m_allocator.deallocate(slots, byteCount, AllocationAlignment);
 		}
 
-		size_t compute_bucket_index(size_t bucketCount, const Key& key) const noexcept
+		void destroy() noexcept
 		{
-			return m_hasher(key) % bucketCount;
+			if (m_slots == nullptr)
+			{
+				return;
+			}
+
+			for (size_t i = 0; i < m_bucket_count; i++)
+			{
+				if (HashControl::is_full(m_control[i]))
+				{
+					std::destroy_at(m_slots + i);
+				}
+			}
+
+			deallocate_buckets(m_slots, m_bucket_count);
+
+			m_slots = nullptr;
+			m_control = nullptr;
+			m_bucket_count = 0;
+			m_element_count = 0;
+			m_deleted_count = 0;
 		}
 
 		void copy_construct(const BasicHashMap& other) noexcept
 		{
-			m_buckets.reset(new BucketType[other.m_bucket_count]);
 			m_hasher = other.m_hasher;
+			m_allocator = other.m_allocator;
+
+			if (other.m_slots == nullptr)
+			{
+				// Copying a moved-from map
+				allocate_buckets(InitialBucketCount);
+				return;
+			}
+
+			allocate_buckets(other.m_bucket_count);
 			m_element_count = other.m_element_count;
-			m_bucket_count = other.m_bucket_count;
+			m_deleted_count = other.m_deleted_count;
+
+			std::copy_n(other.m_control, m_bucket_count + ClonedControlCount, m_control);
+
+			if constexpr (CacheHashes)
+			{
+				std::copy_n(other.cached_hashes(), m_bucket_count, cached_hashes());
+			}
 
 			for (size_t i = 0; i < m_bucket_count; i++)
 			{
-				const auto& srcBucket = other.m_buckets[i];
-				auto& dstBucket = m_buckets[i];
-				dstBucket.resize(srcBucket.size());
-				std::ranges::copy(srcBucket.begin(), srcBucket.end(), std::back_inserter(dstBucket));
+				if (HashControl::is_full(m_control[i]))
+				{
+					std::construct_at(m_slots + i, other.m_slots[i]);
+				}
 			}
 		}
 
 		void move_construct(BasicHashMap&& other) noexcept
 		{
-			m_buckets = CSTM_Move(other.m_buckets);
-			m_hasher = CSTM_Move(other.m_hasher);
-			m_element_count = other.m_element_count;
-			m_bucket_count = other.m_bucket_count;
-
-			other.m_element_count = 0;
-			other.m_bucket_count = 0;
+			m_slots = std::exchange(other.m_slots, nullptr);
+			m_control = std::exchange(other.m_control, nullptr);
+			m_hasher = std::move(other.m_hasher);
+			m_allocator = other.m_allocator;
+			m_element_count = std::exchange(other.m_element_count, 0);
+			m_deleted_count = std::exchange(other.m_deleted_count, 0);
+			m_bucket_count = std::exchange(other.m_bucket_count, 0);
 		}
 
 	private:
-		BucketList m_buckets;
+		Slot* m_slots = nullptr;
+		int8_t* m_control = nullptr;
 		CSTM_NoUniqueAddr Hash m_hasher;
+		CSTM_NoUniqueAddr Alloc m_allocator;
 
-		size_t m_element_count;
-		size_t m_bucket_count;
+		size_t m_element_count = 0;
+		size_t m_deleted_count = 0;
+		size_t m_bucket_count = 0;
 	};
 
 	template<typename Key, typename Value, Hasher<Key> Hash = std::hash<Key>>
 	using HashMap = BasicHashMap<Key, Value, SecureHash<Key, Hash>>;
 
+	// Hash map that allocates from an Arena, construct it with the arena, e.g ArenaHashMap<K, V> map(arena)
+	template<typename Key, typename Value, Hasher<Key> Hash = std::hash<Key>>
+	using ArenaHashMap = BasicHashMap<Key, Value, SecureHash<Key, Hash>, CacheHashesByDefault<Key>, ArenaAllocator>;
+
 	// NOTE(Peter): Hash map that doesn't use SecureHash to ensure unpredictable hash generation.
 	//				I don't recommend utilizing this for anything other than tests where deterministic hash values
 	//				are required.
@@ -0,0 +1,78 @@
+#pragma once
+
+// NOTE(Peter): Instruction sets are only used if the compiler is allowed to emit them (e.g -mavx2 or /arch:AVX2),
+//				or for SSSE3 if CSTM_ENABLE_SSSE3 is defined (MSVC has no /arch for it). See the options in CMakeLists.txt.
+//				CSTM_DISABLE_SIMD can be defined to force the portable fallbacks everywhere.
+//				Since some types change layout depending on these the same flags have to be used for every translation unit.
+#if !defined(CSTM_DISABLE_SIMD)
+	#if defined(__AVX2__)
+		#define CSTM_SIMD_AVX2 1
+	#endif
+
+	#if defined(__SSSE3__) || defined(CSTM_SIMD_AVX2) || defined(CSTM_ENABLE_SSSE3)
+		#define CSTM_SIMD_SSSE3 1
+	#endif
+
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define CSTM_SIMD_SSE2 1
+	#endif
+#endif
+
+#if defined(CSTM_SIMD_AVX2)
+	#include <immintrin.h>
+#elif defined(CSTM_SIMD_SSSE3)
+	#include <tmmintrin.h>
+#elif defined(CSTM_SIMD_SSE2)
+	#include <emmintrin.h>
+#endif
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CSTM {
+
+#if defined(CSTM_SIMD_SSE2)
+	// Block of bytes that's compared all at once by the byte searching algorithms, comparisons yield one bit per byte
+	struct ByteBlock
+	{
+	#if defined(CSTM_SIMD_AVX2)
+		static constexpr size_t Width = 32;
+
+		[[nodiscard]]
+		static ByteBlock load(const byte* bytes) noexcept { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes)) }; }
+
+		[[nodiscard]]
+		static ByteBlock splat(byte value) noexcept { return { _mm256_set1_epi8(static_cast<char>(value)) }; }
+
+		[[nodiscard]]
+		uint32_t match(ByteBlock other) const noexcept { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(value, other.value))); }
+
+		// One bit per byte that has its high bit set (e.g isn't ASCII)
+		[[nodiscard]]
+		uint32_t high_bits() const noexcept { return static_cast<uint32_t>(_mm256_movemask_epi8(value)); }
+
+		__m256i value;
+	#else
+		static constexpr size_t Width = 16;
+
+		[[nodiscard]]
+		static ByteBlock load(const byte* bytes) noexcept { return { _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)) }; }
+
+		[[nodiscard]]
+		static ByteBlock splat(byte value) noexcept { return { _mm_set1_epi8(static_cast<char>(value)) }; }
+
+		[[nodiscard]]
+		uint32_t match(ByteBlock other) const noexcept { return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(value, other.value))); }
+
+		// One bit per byte that has its high bit set (e.g isn't ASCII)
+		[[nodiscard]]
+		uint32_t high_bits() const noexcept { return static_cast<uint32_t>(_mm_movemask_epi8(value)); }
+
+		__m128i value;
+	#endif
+	};
+#endif
+
+}
@@ -15,6 +15,7 @@ namespace CSTM {
 		}
 
 		Span(std::ranges::contiguous_range auto&& range)
+			requires(std::same_as<std::remove_cv_t<std::ranges::range_value_t<decltype(range)>>, T>)
 			: m_begin(range.data()), m_end(range.data() + range.size())
 		{
 		}
@@ -1,13 +1,139 @@
 #include "Assert.hpp"
+#include "CodePointIndex.hpp"
 #include "String.hpp"
 #include "StringView.hpp"
 #include "Unicode.hpp"
 
 #include <algorithm>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <utility>
 
 namespace CSTM {
 
+	/*
+	 * The pool is split into shards that each have their own lock, so threads only contend if they create or destroy
+	 * strings that end up in the same shard.
+	 * Strings are pooled by their contents, the hash only decides where to look, so two different strings with the
+	 * same hash simply get separate storage. This is what allows operator== to compare pooled strings by pointer.
+	 *
+	 * Storage is only ever revived (ref count going from 0 to 1) while holding the lock of its shard, so the last
+	 * reference to a pooled storage has to be released under that same lock, otherwise another thread could
+	 * find the storage in the pool right before it's destroyed.
+	 */
+	class String::Pool
+	{
+	public:
+		static constexpr size_t ShardCount = 64;
+
+		// Returns the pooled storage for bytes, creating it if it doesn't exist yet, the caller owns one reference
+		[[nodiscard]]
+		LargeStorage* acquire(const byte* bytes, size_t byteCount, size_t hash)
+		{
+			auto& shard = shard_for(hash);
+			std::scoped_lock lock(shard.mutex);
+
+			// NOTE(Peter): Only look the key up once, a hit compares the full contents of the string
+			if (LargeStorage** pooled = shard.storages.find(Key{ bytes, byteCount, hash }); pooled != nullptr)
+			{
+				LargeStorage* storage = *pooled;
+				storage->ref_count.fetch_add(1, std::memory_order_relaxed);
+				return storage;
+			}
+
+			LargeStorage* storage = LargeStorage::create(byteCount, hash, LargeStorageType::Pooled);
+			std::copy_n(bytes, byteCount, storage->data());
+
+			// NOTE(Peter): The key has to refer to the pooled bytes, the bytes we were given are gone after this call
+			shard.storages.insert(key_of(storage), storage);
+			return storage;
+		}
+
+		void release(LargeStorage* storage) noexcept
+		{
+			size_t refCount = storage->ref_count.load(std::memory_order_relaxed);
+
+			// NOTE(Peter): Dropping anything but the last reference doesn't need the lock
+			while (refCount > 1)
+			{
+				if (storage->ref_count.compare_exchange_weak(refCount, refCount - 1, std::memory_order_release, std::memory_order_relaxed))
+				{
+					return;
+				}
+			}
+
+			auto& shard = shard_for(storage->hash_code);
+			std::scoped_lock lock(shard.mutex);
+
+			// Someone may have acquired the storage from the pool while we were waiting for the lock
+			if (storage->ref_count.fetch_sub(1, std::memory_order_acq_rel) > 1)
+			{
+				return;
+			}
+
+			shard.storages.remove(key_of(storage));
+			LargeStorage::destroy(storage);
+		}
+
+	private:
+		// Identifies a pooled string by its contents
+		struct Key
+		{
+			const byte* bytes;
+			size_t byte_count;
+			size_t hash;
+
+			bool operator==(const Key& other) const noexcept
+			{
+				if (hash != other.hash || byte_count != other.byte_count)
+				{
+					return false;
+				}
+
+				return bytes == other.bytes || std::equal(bytes, bytes + byte_count, other.bytes);
+			}
+		};
+
+		// NOTE(Peter): The key already carries a (seeded) hash, there's no point in hashing or caching it again
+		struct KeyHash
+		{
+			using is_avalanching = void;
+
+			size_t operator()(const Key& key) const noexcept { return key.hash; }
+		};
+
+		struct alignas(64) Shard
+		{
+			std::mutex mutex;
+			BasicHashMap<Key, LargeStorage*, KeyHash, false> storages;
+		};
+
+		[[nodiscard]]
+		static Key key_of(LargeStorage* storage) noexcept
+		{
+			return { storage->data(), storage->byte_count, storage->hash_code };
+		}
+
+		[[nodiscard]]
+		Shard& shard_for(const size_t hash) noexcept
+		{
+			// NOTE(Peter): The top bits, the lower bits are used by the HashMap of the shard
+			return m_shards[hash >> (std::numeric_limits<size_t>::digits - std::countr_zero(ShardCount))];
+		}
+
+	private:
+		Shard m_shards[ShardCount];
+	};
+
+	String::Pool& String::string_pool() noexcept
+	{
+		static Pool pool;
+		return pool;
+	}
+
 	String String::create(const char* str)
 	{
 		// NOTE(Peter): Lets face it, it's increadibly unlikely for char
@@ -52,32 +178,86 @@ namespace CSTM {
 		return string;
 	}
 
+	String String::create(std::string_view str, Arena& arena)
+	{
+		String string;
+		string.allocate_from(reinterpret_cast<const byte*>(str.data()), str.length(), LargeStorageType::Arena, &arena);
+		return string;
+	}
+
+	String String::create(Span<byte> bytes, Arena& arena)
+	{
+		String string;
+		string.allocate_from(bytes.begin(), bytes.byte_count(), LargeStorageType::Arena, &arena);
+		return string;
+	}
+
+	String String::create_unique(std::string_view str)
+	{
+		String string;
+		string.allocate_from(reinterpret_cast<const byte*>(str.data()), str.length(), LargeStorageType::Unique);
+		return string;
+	}
+
+	String String::create_unique(Span<byte> bytes)
+	{
+		String string;
+		string.allocate_from(bytes.begin(), bytes.byte_count(), LargeStorageType::Unique);
+		return string;
+	}
+
+	Result<String, StringError> String::try_create(std::string_view str)
+	{
+		if (!validate_utf8(reinterpret_cast<const byte*>(str.data()), str.length()))
+		{
+			return StringError::InvalidUtf8;
+		}
+
+		String string;
+		string.allocate_from(reinterpret_cast<const byte*>(str.data()), str.length());
+		string.cache_valid_utf8();
+		return string;
+	}
+
+	Result<String, StringError> String::try_create(Span<byte> bytes)
+	{
+		// NOTE(Peter): Validating right before copying means the copy (or the pool's hash) reads the bytes from cache
+		if (!validate_utf8(bytes.begin(), bytes.byte_count()))
+		{
+			return StringError::InvalidUtf8;
+		}
+
+		String string;
+		string.allocate_from(bytes.begin(), bytes.byte_count());
+		string.cache_valid_utf8();
+		return string;
+	}
+
 	String::String(const String& other) noexcept
-		: m_byte_count(other.m_byte_count)
 	{
 		if (other.is_large_string())
 		{
-			m_large_storage = other.m_large_storage;
-			m_large_storage->ref_count++;
+			m_large = other.m_large;
+			m_large.storage->ref_count++;
 		}
 		else
 		{
-			std::copy_n(other.m_small_storage, other.m_byte_count, m_small_storage);
+			m_small = other.m_small;
 		}
 	}
 
 	String::String(String&& other) noexcept
-		: m_byte_count(std::exchange(other.m_byte_count, 0))
 	{
-		if (is_large_string())
+		if (other.is_large_string())
 		{
-			m_large_storage = std::exchange(other.m_large_storage, nullptr);
+			m_large = other.m_large;
 		}
 		else
 		{
-			std::copy_n(other.m_small_storage, m_byte_count, m_small_storage);
-			std::fill_n(other.m_small_storage, SmallStringLength, 0);
+			m_small = other.m_small;
 		}
+
+		other.m_small = {};
 	}
 
 	String::~String() noexcept
@@ -94,17 +274,14 @@ namespace CSTM {
 
 		try_decrease_ref_count();
 
-		m_byte_count = other.m_byte_count;
-
 		if (other.is_large_string())
 		{
-			m_large_storage = other.m_large_storage;
-			m_large_storage->ref_count++;
+			m_large = other.m_large;
+			m_large.storage->ref_count++;
 		}
 		else
 		{
-			std::fill_n(m_small_storage, SmallStringLength, 0);
-			std::copy_n(other.m_small_storage, other.m_byte_count, m_small_storage);
+			m_small = other.m_small;
 		}
 
 		return *this;
@@ -119,19 +296,16 @@ namespace CSTM {
 
 		try_decrease_ref_count();
 
-		m_byte_count = std::exchange(other.m_byte_count, 0);
-
-		if (is_large_string())
+		if (other.is_large_string())
 		{
-			m_large_storage = std::exchange(other.m_large_storage, nullptr);
+			m_large = other.m_large;
 		}
 		else
 		{
-			std::fill_n(m_small_storage, SmallStringLength, 0);
-			std::copy_n(other.m_small_storage, m_byte_count, m_small_storage);
-			std::fill_n(other.m_small_storage, SmallStringLength, 0);
+			m_small = other.m_small;
 		}
 
+		other.m_small = {};
 		return *this;
 	}
 
@@ -142,34 +316,78 @@ namespace CSTM {
 			return true;
 		}
 
-		if (m_byte_count != other.m_byte_count)
+		if (byte_count() != other.byte_count())
 		{
 			return false;
 		}
 
 		if (is_large_string())
 		{
-			// If we're a large string we can do simple pointer comparison
-			return m_large_storage == other.m_large_storage;
+			// If we're a large string we can do simple pointer comparison, since the pool is keyed by content
+			// two pooled strings with the same bytes always share their storage
+			if (m_large.storage == other.m_large.storage)
+			{
+				return true;
+			}
+
+			if (m_large.storage->type == LargeStorageType::Pooled && other.m_large.storage->type == LargeStorageType::Pooled)
+			{
+				return false;
+			}
+
+			return std::equal(data(), data() + m_large.byte_count, other.data());
 		}
 
 		// Otherwise we have to do full string comparison
-		return std::equal(std::begin(m_small_storage), std::end(m_small_storage), std::begin(other.m_small_storage));
+		// NOTE(Peter): Unused bytes of small strings are always zero, so we can compare all of them at once
+		return std::equal(std::begin(m_small.data), std::end(m_small.data), std::begin(other.m_small.data));
+	}
+
+	bool String::operator==(const StringView& other) const noexcept
+	{
+		if (byte_count() != other.byte_count())
+		{
+			return false;
+		}
+
+		return std::equal(data(), data() + other.byte_count(), other.data());
+	}
+
+	bool String::operator==(const char* str) const noexcept
+	{
+		const size_t length = std::char_traits<char>::length(str);
+
+		if (length != byte_count())
+		{
+			return false;
+		}
+
+		return std::equal(data(), data() + length, reinterpret_cast<const byte*>(str));
+	}
+
+	bool String::operator==(Span<byte> bytes) const noexcept
+	{
+		if (bytes.count() != byte_count())
+		{
+			return false;
+		}
+
+		return std::equal(bytes.begin(), bytes.end(), data());
 	}
 
 	Result<StringView, StringError> String::view(size_t offset, size_t length) const noexcept
 	{
-		if (offset >= m_byte_count)
+		if (offset >= byte_count())
 		{
 			return StringError::InvalidOffset;
 		}
 
 		if (length == ~0)
 		{
-			length = m_byte_count - offset;
+			length = byte_count() - offset;
 		}
 
-		if (length > m_byte_count - offset)
+		if (length > byte_count() - offset)
 		{
 			return StringError::InvalidLength;
 		}
@@ -177,52 +395,183 @@ namespace CSTM {
 		return StringView{ data() + offset, length };
 	}
 
-	void String::try_decrease_ref_count() const noexcept
+	size_t String::code_point_count() const noexcept
 	{
 		if (!is_large_string())
 		{
-			return;
+			return count_code_points(m_small.data, m_small.byte_count);
 		}
 
-		if (--m_large_storage->ref_count > 0)
+		LargeStorage* storage = m_large.storage;
+		size_t count = storage->code_point_count.load(std::memory_order_relaxed);
+
+		if (count == LargeStorage::UnknownCodePointCount)
 		{
-			return;
+			count = count_code_points(storage->data(), storage->byte_count);
+			storage->code_point_count.store(count, std::memory_order_relaxed);
 		}
 
-		StringPool.remove(m_large_storage->hash_code);
-
-		delete[] m_large_storage->data;
-		delete m_large_storage;
+		return count;
 	}
 
-	void String::allocate_from(const byte* bytes, size_t byteCount)
+	bool String::is_valid_utf8() const noexcept
 	{
-		CSTM_Assert(m_byte_count == 0);
+		if (!is_large_string())
+		{
+			return validate_utf8(m_small.data, m_small.byte_count);
+		}
+
+		LargeStorage* storage = m_large.storage;
+		Utf8Status status = storage->utf8_status.load(std::memory_order_relaxed);
 
-		m_byte_count = byteCount;
+		if (status == Utf8Status::Unknown)
+		{
+			status = validate_utf8(storage->data(), storage->byte_count) ? Utf8Status::Valid : Utf8Status::Invalid;
+			storage->utf8_status.store(status, std::memory_order_relaxed);
+		}
+
+		return status == Utf8Status::Valid;
+	}
 
+	void String::cache_valid_utf8() const noexcept
+	{
 		if (is_large_string())
 		{
-			const size_t hash = SecureHash<std::u8string_view>{}(std::u8string_view{ reinterpret_cast<const char8_t*>(bytes), byteCount });
+			m_large.storage->utf8_status.store(Utf8Status::Valid, std::memory_order_relaxed);
+		}
+	}
 
-			if (!StringPool.contains(hash))
-			{
-				m_large_storage = new LargeStorage();
-				m_large_storage->data = new byte[m_byte_count];
-				m_large_storage->ref_count = 1;
-				m_large_storage->hash_code = hash;
+	Result<uint32_t, NullType> String::code_point_at(size_t index) const noexcept
+	{
+		return decode_code_point_at(data(), byte_count(), code_point_byte_offset(index));
+	}
+
+	Result<StringView, StringError> String::view_code_points(size_t offset, size_t length) const noexcept
+	{
+		const size_t codePointCount = code_point_count();
+
+		if (offset >= codePointCount)
+		{
+			return StringError::InvalidOffset;
+		}
+
+		if (length == ~0)
+		{
+			length = codePointCount - offset;
+		}
+
+		if (length > codePointCount - offset)
+		{
+			return StringError::InvalidLength;
+		}
 
-				StringPool.insert(hash, m_large_storage);
+		const size_t begin = code_point_byte_offset(offset);
+		const size_t end = code_point_byte_offset(offset + length);
+		return StringView{ data() + begin, end - begin };
+	}
+
+	size_t String::code_point_byte_offset(size_t index) const noexcept
+	{
+		// NOTE(Peter): Below this it's cheaper to just skip over the code points than to allocate an index,
+		//				and arena storage is never destroyed, so it would leak the index
+		static constexpr size_t IndexedByteCount = 1024;
+
+		if (!is_large_string() || m_large.byte_count < IndexedByteCount || m_large.storage->type == LargeStorageType::Arena)
+		{
+			return code_point_offset(data(), byte_count(), index);
+		}
+
+		LargeStorage* storage = m_large.storage;
+		CodePointIndex* codePointIndex = storage->code_point_index.load(std::memory_order_acquire);
+
+		if (codePointIndex == nullptr)
+		{
+			// Only one thread gets to publish its index, everyone else throws theirs away and uses that one
+			auto* newIndex = new CodePointIndex(storage->data(), storage->byte_count);
+
+			if (storage->code_point_index.compare_exchange_strong(codePointIndex, newIndex, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				codePointIndex = newIndex;
 			}
 			else
 			{
-				m_large_storage = StringPool[hash];
-				m_large_storage->ref_count++;
-				return;
+				delete newIndex;
+			}
+		}
+
+		return codePointIndex->byte_offset(index);
+	}
+
+	String::LargeStorage* String::LargeStorage::create(size_t byteCount, size_t hashCode, LargeStorageType type, Arena* arena)
+	{
+		CSTM_Assert((type == LargeStorageType::Arena) == (arena != nullptr));
+
+		const size_t allocationSize = sizeof(LargeStorage) + byteCount;
+		void* memory = arena != nullptr ? arena->allocate(allocationSize, alignof(LargeStorage)) : ::operator new(allocationSize);
+		return new (memory) LargeStorage{ 1, hashCode, byteCount, type };
+	}
+
+	void String::LargeStorage::destroy(LargeStorage* storage) noexcept
+	{
+		CSTM_Assert(storage->type != LargeStorageType::Arena);
+
+		delete storage->code_point_index.load(std::memory_order_acquire);
+		std::destroy_at(storage);
+		::operator delete(static_cast<void*>(storage));
+	}
+
+	void String::try_decrease_ref_count() const noexcept
+	{
+		if (!is_large_string())
+		{
+			return;
+		}
+
+		switch (m_large.storage->type)
+		{
+		case LargeStorageType::Pooled:
+			string_pool().release(m_large.storage);
+			break;
+		case LargeStorageType::Unique:
+			if (m_large.storage->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				LargeStorage::destroy(m_large.storage);
 			}
+			break;
+		case LargeStorageType::Arena:
+			// NOTE(Peter): Arena storage is freed along with the arena
+			m_large.storage->ref_count.fetch_sub(1, std::memory_order_relaxed);
+			break;
+		}
+	}
+
+	void String::allocate_from(const byte* bytes, size_t byteCount, LargeStorageType type, Arena* arena)
+	{
+		CSTM_Assert(byte_count() == 0);
+
+		if (byteCount <= SmallStringLength)
+		{
+			m_small.byte_count = static_cast<uint8_t>(byteCount);
+			std::copy_n(bytes, byteCount, m_small.data);
+			return;
+		}
+
+		LargeStorage* storage = nullptr;
+
+		if (type != LargeStorageType::Pooled)
+		{
+			storage = LargeStorage::create(byteCount, 0, type, arena);
+			std::copy_n(bytes, byteCount, storage->data());
+		}
+		else
+		{
+			const size_t hash = SecureHash<std::u8string_view>{}(std::u8string_view{ reinterpret_cast<const char8_t*>(bytes), byteCount });
+
+			// NOTE(Peter): The pool copies the bytes itself, before any other thread can see the storage
+			storage = string_pool().acquire(bytes, byteCount, hash);
 		}
 
-		std::copy_n(bytes, m_byte_count, data_mut());
+		m_large = { LargeTag, storage, byteCount };
 	}
 
 }
@@ -4,6 +4,7 @@
 #include <atomic>
 
 #include "Types.hpp"
+#include "Allocator.hpp"
 #include "HashMap.hpp"
 #include "Result.hpp"
 #include "StringBase.hpp"
@@ -12,24 +13,96 @@
 namespace CSTM {
 
 	class StringView;
+	class CodePointIndex;
 
 	enum class StringError
 	{
 		InvalidOffset,
-		InvalidLength
+		InvalidLength,
+		InvalidUtf8
 	};
 
 	class String : public StringBase
 	{
+		enum class LargeStorageType : uint8_t
+		{
+			// Interned in the string pool, strings with the same contents share the same storage
+			Pooled,
+
+			// Only shared by copies of the string it was created for
+			Unique,
+
+			// Like Unique, but allocated from an Arena which frees it
+			Arena
+		};
+
+		enum class Utf8Status : uint8_t
+		{
+			Unknown,
+			Valid,
+			Invalid
+		};
+
+		/*
+		 * NOTE(Peter): The bytes of the string are stored directly after the header, in the same allocation.
+		 *				Since the bytes never change, whatever we find out about them is cached here the first time it's
+		 *				asked for, and every copy of the string benefits from it. Threads that race to fill in the cache
+		 *				compute the same values, so relaxed atomics are enough.
+		 */
 		struct LargeStorage
 		{
-			byte* data;
+			static constexpr size_t UnknownCodePointCount = ~0ull;
+
 			std::atomic_size_t ref_count;
 			size_t hash_code;
+			size_t byte_count;
+
+			LargeStorageType type;
+			std::atomic<Utf8Status> utf8_status = Utf8Status::Unknown;
+			std::atomic_size_t code_point_count = UnknownCodePointCount;
+
+			// Built the first time a code point is looked up by index, see code_point_byte_offset
+			std::atomic<CodePointIndex*> code_point_index = nullptr;
+
+			[[nodiscard]]
+			byte* data() noexcept { return reinterpret_cast<byte*>(this + 1); }
+
+			[[nodiscard]]
+			static LargeStorage* create(size_t byteCount, size_t hashCode, LargeStorageType type, Arena* arena = nullptr);
+			static void destroy(LargeStorage* storage) noexcept;
 		};
 
-		static constexpr size_t SmallStringLength = 16 * sizeof(byte);
-		inline static HashMap<size_t, LargeStorage*> StringPool;
+		/*
+		 * Small strings are stored inline, using every byte of the string except for the one holding the byte count.
+		 * Both layouts start with a byte, which lets us tell them apart without knowing which one is active:
+		 *	Small: | byte count (0 - 23) | 23 bytes                               |
+		 *	Large: | LargeTag | padding  | LargeStorage* | byte count             |
+		 */
+		struct LargeLayout
+		{
+			uint8_t tag;
+			LargeStorage* storage;
+			size_t byte_count;
+		};
+
+	public:
+		static constexpr size_t SmallStringLength = sizeof(LargeLayout) - 1;
+
+	private:
+		struct SmallLayout
+		{
+			uint8_t byte_count;
+			byte data[SmallStringLength];
+		};
+
+		static constexpr uint8_t LargeTag = 0xFF;
+		static_assert(SmallStringLength < LargeTag);
+
+		// Interning pool for large strings, safe to use from multiple threads (see String.cpp)
+		class Pool;
+
+		[[nodiscard]]
+		static Pool& string_pool() noexcept;
 
 	public:
 		static String create(const char* str);
@@ -37,18 +110,42 @@ namespace CSTM {
 		static String create(Span<uint32_t> codePoints);
 		static String create(Span<byte> bytes);
 
+		/*
+		 * Allocates the storage of large strings from arena instead of the heap. These strings are never pooled
+		 * since the pool would outlive the arena, and the storage is only freed once the arena is.
+		 * NOTE(Peter): The string (and any copy of it) must not outlive arena
+		 */
+		static String create(std::string_view str, Arena& arena);
+		static String create(Span<byte> bytes, Arena& arena);
+
+		/*
+		 * Creates a string that skips the string pool, which means that large strings aren't hashed (or compared
+		 * against the pool) when they're created. Copies of the string still share its storage.
+		 * Meant for large strings that are rarely compared (e.g a response body), comparing them has to look at
+		 * every byte since they never share storage with equal strings that weren't copied from them.
+		 */
+		static String create_unique(std::string_view str);
+		static String create_unique(Span<byte> bytes);
+
+		/*
+		 * Same as create, except that bytes which aren't valid UTF-8 (see validate_utf8) are rejected with StringError::InvalidUtf8.
+		 * Meant for untrusted input (e.g from the network), which can then be checked once when it comes in.
+		 */
+		static Result<String, StringError> try_create(std::string_view str);
+		static Result<String, StringError> try_create(Span<byte> bytes);
+
 	public:
 		[[nodiscard]]
-		bool is_empty() const noexcept { return m_byte_count == 0; }
+		bool is_empty() const noexcept { return byte_count() == 0; }
 
 		[[nodiscard]]
-		bool is_large_string() const noexcept { return m_byte_count > SmallStringLength; }
+		bool is_large_string() const noexcept { return m_small.byte_count == LargeTag; }
 
 		[[nodiscard]]
-		const byte* data() const noexcept override { return is_large_string() ? m_large_storage->data : m_small_storage; }
+		const byte* data() const noexcept { return is_large_string() ? m_large.storage->data() : m_small.data; }
 
 		[[nodiscard]]
-		size_t byte_count() const noexcept override { return m_byte_count; }
+		size_t byte_count() const noexcept { return is_large_string() ? m_large.byte_count : m_small.byte_count; }
 
 		[[nodiscard]]
 		byte byte_at(const size_t index) const { return data()[index]; }
@@ -56,27 +153,57 @@ namespace CSTM {
 		[[nodiscard]]
 		bool operator==(const String& other) const noexcept;
 
+		[[nodiscard]]
+		bool operator==(const StringView& other) const noexcept;
+
+		[[nodiscard]]
+		bool operator==(const char* str) const noexcept;
+
+		[[nodiscard]]
+		bool operator==(Span<byte> bytes) const noexcept;
+
 		[[nodiscard]]
 		bool operator==(const std::ranges::contiguous_range auto& str) const noexcept
 			requires(std::same_as<std::ranges::range_value_t<decltype(str)>, char>)
 		{
 			size_t strLength = std::ranges::size(str);
 
-			if (str[strLength - 1] == '\0')
+			if (strLength > 0 && str[strLength - 1] == '\0')
 			{
 				strLength--;
 			}
 
-			if (m_byte_count != strLength)
+			if (byte_count() != strLength)
 			{
 				return false;
 			}
 
-			return std::equal(data(), data() + m_byte_count, str);
+			return std::equal(data(), data() + strLength, std::ranges::begin(str));
 		}
 
+		/*
+		 * Same as the StringBase versions, but large strings compute these once and cache them in their storage,
+		 * which makes asking again (from any copy of the string) O(1). is_ascii is derived from the other two.
+		 */
+		[[nodiscard]]
+		size_t code_point_count() const noexcept;
+
+		[[nodiscard]]
+		bool is_valid_utf8() const noexcept;
+
+		/*
+		 * Same as StringBase::code_point_at, large strings build a CodePointIndex the first time this is called and keep it
+		 * in their storage, after that looking up any code point (in any copy of the string) takes roughly constant time.
+		 */
 		[[nodiscard]]
-		size_t ref_count() const noexcept { return is_large_string() ? m_large_storage->ref_count.load() : 1; }
+		Result<uint32_t, NullType> code_point_at(size_t index) const noexcept;
+
+		// Like view, except that offset and length are in code points instead of bytes
+		[[nodiscard]]
+		Result<StringView, StringError> view_code_points(size_t offset, size_t length = ~0) const noexcept;
+
+		[[nodiscard]]
+		size_t ref_count() const noexcept { return is_large_string() ? m_large.storage->ref_count.load() : 1; }
 
 		[[nodiscard]]
 		Result<StringView, StringError> view(size_t offset = 0, size_t length = ~0) const noexcept;
@@ -86,9 +213,9 @@ namespace CSTM {
 			requires(std::same_as<std::ranges::range_value_t<decltype(str)>, char>)
 		{
 			std::vector<byte> originalChars;
-			originalChars.resize(m_byte_count);
+			originalChars.resize(byte_count());
 
-			std::ranges::copy(data(), data() + m_byte_count, originalChars.begin());
+			std::ranges::copy(data(), data() + byte_count(), originalChars.begin());
 
 			auto it = std::ranges::find(originalChars, str[0]);
 
@@ -104,7 +231,7 @@ namespace CSTM {
 				strLength--;
 			}
 
-			if (m_byte_count < strLength)
+			if (byte_count() < strLength)
 			{
 				return *this;
 			}
@@ -141,19 +268,26 @@ namespace CSTM {
 		Result<String, StringError> remove_any(const std::ranges::contiguous_range auto& chars) const noexcept
 			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
 		{
-			std::vector<byte> originalChars;
-			originalChars.resize(m_byte_count);
+			const ByteSet toRemove = make_byte_set(chars);
+			const byte* str = data();
+			const size_t length = byte_count();
 
-			std::ranges::copy(data(), data() + m_byte_count, originalChars.begin());
+			std::vector<byte> remainingChars;
+			remainingChars.reserve(length);
 
-			auto toErase = std::ranges::remove_if(originalChars, [&](byte c)
+			// Copy everything in between the runs of bytes that should be removed
+			for (size_t offset = 0; offset < length;)
 			{
-				return std::ranges::contains(chars, c);
-			});
+				const size_t removeOffset = toRemove.find_first_in(str + offset, length - offset);
+				const size_t keepCount = removeOffset != NotFound ? removeOffset : length - offset;
+				remainingChars.insert(remainingChars.end(), str + offset, str + offset + keepCount);
+				offset += keepCount;
 
-			originalChars.erase(toErase.begin(), toErase.end());
+				const size_t keepOffset = toRemove.find_first_not_in(str + offset, length - offset);
+				offset = keepOffset != NotFound ? offset + keepOffset : length;
+			}
 
-			return create(Span<byte>(originalChars));
+			return create(Span<byte>(remainingChars));
 		}
 
 		[[nodiscard]]
@@ -179,7 +313,8 @@ namespace CSTM {
 		}
 
 	private:
-		template<std::derived_from<CodePointIteratorBase> Iterator>
+		template<typename Iterator>
+			requires(std::same_as<Iterator, CodePointIterator> || std::same_as<Iterator, CodePointReverseIterator>)
 		[[nodiscard]]
 		Result<String, StringError> remove_code_points_impl(const std::ranges::contiguous_range auto& codePoints) const noexcept
 		{
@@ -211,26 +346,34 @@ namespace CSTM {
 		String() noexcept = default;
 		String(const String& other) noexcept;
 		String(String&& other) noexcept;
-		~String() noexcept override;
+		~String() noexcept;
 
 		String& operator=(const String& other) noexcept;
 		String& operator=(String&& other) noexcept;
 
 	private:
 		void try_decrease_ref_count() const noexcept;
-		void allocate_from(const byte* data, size_t byteCount);
+		void allocate_from(const byte* data, size_t byteCount, LargeStorageType type = LargeStorageType::Pooled, Arena* arena = nullptr);
+
+		// Remembers that the string is valid UTF-8 without checking, for strings that have already been validated
+		void cache_valid_utf8() const noexcept;
+
+		// Byte offset of the code point at index, or byte_count() if there's no such code point
+		[[nodiscard]]
+		size_t code_point_byte_offset(size_t index) const noexcept;
 
 		[[nodiscard]]
-		byte* data_mut() { return is_large_string() ? m_large_storage->data : m_small_storage; }
+		byte* data_mut() { return is_large_string() ? m_large.storage->data() : m_small.data; }
 
 	private:
 		union
 		{
-			byte m_small_storage[SmallStringLength]{};
-			LargeStorage* m_large_storage;
+			SmallLayout m_small{};
+			LargeLayout m_large;
 		};
-
-		size_t m_byte_count = 0;
 	};
 
 }
+
+template<>
+struct std::hash<CSTM::String> : CSTM::StringHash {};
@@ -2,75 +2,178 @@
 
 #include "Types.hpp"
 #include "CodePointIterator.hpp"
+#include "Hash.hpp"
+#include "Span.hpp"
+#include "StringSearch.hpp"
+#include "Unicode.hpp"
 
 #include <algorithm>
 #include <ranges>
+#include <vector>
 
 namespace CSTM {
 
+	/*
+	 * Shared functionality of String and StringView. Every member function deduces the type of this, and uses
+	 * the data() and byte_count() of the derived class directly, so there are no virtual calls (or vtable pointers) involved.
+	 * NOTE(Peter): Derived classes have to provide data() and byte_count(), see the StringType concept below
+	 */
 	class StringBase
 	{
+	protected:
+		StringBase() noexcept = default;
+		~StringBase() noexcept = default;
+
 	public:
-		virtual ~StringBase() = default;
+		// Number of code points in the string, counted without decoding them (see count_code_points)
+		[[nodiscard]]
+		size_t code_point_count(this const auto& self) noexcept
+		{
+			return count_code_points(self.data(), self.byte_count());
+		}
 
+		// See validate_utf8
 		[[nodiscard]]
-		virtual const byte* data() const noexcept = 0;
+		bool is_valid_utf8(this const auto& self) noexcept
+		{
+			return validate_utf8(self.data(), self.byte_count());
+		}
 
+		// Code point at index (counted the same way as code_point_count), or Null if there are only index code points or fewer
 		[[nodiscard]]
-		virtual size_t byte_count() const noexcept = 0;
+		Result<uint32_t, NullType> code_point_at(this const auto& self, size_t index) noexcept
+		{
+			return decode_code_point_at(self.data(), self.byte_count(), code_point_offset(self.data(), self.byte_count(), index));
+		}
+
+		[[nodiscard]]
+		bool is_ascii(this const auto& self) noexcept
+		{
+			// NOTE(Peter): Every ASCII byte counts as a code point, and valid UTF-8 can only have as many code points
+			//				as bytes if none of them are part of a longer sequence
+			return self.code_point_count() == self.byte_count() && self.is_valid_utf8();
+		}
 
-	public:
 		[[nodiscard]]
-		bool contains(const std::ranges::contiguous_range auto& chars) const
+		bool contains(this const auto& self, const std::ranges::contiguous_range auto& chars)
 			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
 		{
-			const byte* str = data();
-			const size_t length = byte_count();
+			return self.find(chars) != NotFound;
+		}
 
-			size_t charsSize = std::ranges::size(chars);
+		// Returns the byte offset of the first occurrence of chars at or after offset, or NotFound
+		[[nodiscard]]
+		size_t find(this const auto& self, const std::ranges::contiguous_range auto& chars, size_t offset = 0)
+			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
+		{
+			const size_t length = self.byte_count();
 
-			if (chars[charsSize - 1] == '\0')
+			if (offset > length)
 			{
-				charsSize--;
+				return NotFound;
 			}
 
-			if (length < charsSize)
+			const size_t result = find_bytes(self.data() + offset, length - offset, reinterpret_cast<const byte*>(std::ranges::data(chars)), char_count(chars));
+			return result != NotFound ? result + offset : NotFound;
+		}
+
+		// Returns the byte offset of the last occurrence of chars, or NotFound
+		[[nodiscard]]
+		size_t rfind(this const auto& self, const std::ranges::contiguous_range auto& chars)
+			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
+		{
+			return rfind_bytes(self.data(), self.byte_count(), reinterpret_cast<const byte*>(std::ranges::data(chars)), char_count(chars));
+		}
+
+		// Returns the byte offsets of every non-overlapping occurrence of chars, in order
+		[[nodiscard]]
+		std::vector<size_t> find_all(this const auto& self, const std::ranges::contiguous_range auto& chars)
+			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
+		{
+			const byte* str = self.data();
+			const size_t length = self.byte_count();
+			const size_t charsSize = char_count(chars);
+
+			std::vector<size_t> offsets;
+
+			if (charsSize == 0)
 			{
-				return false;
+				return offsets;
 			}
 
-			const auto begin = std::ranges::begin(chars);
+			for (size_t offset = 0; offset + charsSize <= length; offset += charsSize)
+			{
+				const size_t result = find_bytes(str + offset, length - offset, reinterpret_cast<const byte*>(std::ranges::data(chars)), charsSize);
+
+				if (result == NotFound)
+				{
+					break;
+				}
+
+				offset += result;
+				offsets.push_back(offset);
+			}
 
-			return std::ranges::contains_subrange(
-				str, str + length,
-				begin, std::ranges::next(begin, charsSize)
-			);
+			return offsets;
 		}
 
 		[[nodiscard]]
-		bool contains_any(const std::ranges::contiguous_range auto& chars) const
+		bool contains_any(this const auto& self, const std::ranges::contiguous_range auto& chars)
 			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
 		{
-			const byte* str = data();
-			const size_t length = byte_count();
+			return self.find_first_of(chars) != NotFound;
+		}
 
-			for (size_t i = 0; i < length; i++)
+		// Returns the byte offset of the first byte at or after offset that is one of chars, or NotFound
+		[[nodiscard]]
+		size_t find_first_of(this const auto& self, const std::ranges::contiguous_range auto& chars, size_t offset = 0)
+			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
+		{
+			if (offset >= self.byte_count())
 			{
-				if (std::ranges::contains(chars, str[i]))
-				{
-					return true;
-				}
+				return NotFound;
 			}
 
-			return false;
+			const size_t result = make_byte_set(chars).find_first_in(self.data() + offset, self.byte_count() - offset);
+			return result != NotFound ? result + offset : NotFound;
 		}
 
+		// Returns the byte offset of the first byte at or after offset that isn't one of chars, or NotFound
 		[[nodiscard]]
-		bool starts_with(const std::ranges::contiguous_range auto& chars) const
+		size_t find_first_not_of(this const auto& self, const std::ranges::contiguous_range auto& chars, size_t offset = 0)
 			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
 		{
-			const byte* str = data();
-			const size_t length = byte_count();
+			if (offset >= self.byte_count())
+			{
+				return NotFound;
+			}
+
+			const size_t result = make_byte_set(chars).find_first_not_in(self.data() + offset, self.byte_count() - offset);
+			return result != NotFound ? result + offset : NotFound;
+		}
+
+		// Returns the byte offset of the last byte that is one of chars, or NotFound
+		[[nodiscard]]
+		size_t find_last_of(this const auto& self, const std::ranges::contiguous_range auto& chars)
+			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
+		{
+			return make_byte_set(chars).find_last_in(self.data(), self.byte_count());
+		}
+
+		// Returns the byte offset of the last byte that isn't one of chars, or NotFound
+		[[nodiscard]]
+		size_t find_last_not_of(this const auto& self, const std::ranges::contiguous_range auto& chars)
+			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
+		{
+			return make_byte_set(chars).find_last_not_in(self.data(), self.byte_count());
+		}
+
+		[[nodiscard]]
+		bool starts_with(this const auto& self, const std::ranges::contiguous_range auto& chars)
+			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
+		{
+			const byte* str = self.data();
+			const size_t length = self.byte_count();
 
 			size_t charsSize = std::ranges::size(chars);
 
@@ -96,10 +199,10 @@ namespace CSTM {
 		}
 
 		[[nodiscard]]
-		bool starts_with_any(const std::ranges::contiguous_range auto& chars) const
+		bool starts_with_any(this const auto& self, const std::ranges::contiguous_range auto& chars)
 			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
 		{
-			const byte* str = data();
+			const byte* str = self.data();
 
 			for (const auto c : chars)
 			{
@@ -113,12 +216,12 @@ namespace CSTM {
 		}
 
 		[[nodiscard]]
-		bool starts_with_any_code_point(const std::ranges::contiguous_range auto& codePoints) const
+		bool starts_with_any_code_point(this const auto& self, const std::ranges::contiguous_range auto& codePoints)
 			requires(std::same_as<std::ranges::range_value_t<decltype(codePoints)>, uint32_t>)
 		{
 			bool result = false;
 
-			CodePointIterator{ *this }.each([&](const uint32_t codePoint)
+			CodePointIterator{ self }.each([&](const uint32_t codePoint)
 			{
 				for (auto c : codePoints)
 				{
@@ -137,11 +240,11 @@ namespace CSTM {
 		}
 
 		[[nodiscard]]
-		bool ends_with(const std::ranges::contiguous_range auto& chars) const
+		bool ends_with(this const auto& self, const std::ranges::contiguous_range auto& chars)
 			requires(std::same_as<std::ranges::range_value_t<decltype(chars)>, char>)
 		{
-			const byte* str = data();
-			const size_t length = byte_count();
+			const byte* str = self.data();
+			const size_t length = self.byte_count();
 
 			size_t charsSize = std::ranges::size(chars);
 
@@ -167,12 +270,12 @@ namespace CSTM {
 		}
 
 		[[nodiscard]]
-		bool ends_with_any_code_point(const std::ranges::contiguous_range auto& codePoints) const
+		bool ends_with_any_code_point(this const auto& self, const std::ranges::contiguous_range auto& codePoints)
 			requires(std::same_as<std::ranges::range_value_t<decltype(codePoints)>, uint32_t>)
 		{
 			bool result = false;
 
-			CodePointReverseIterator{ *this }.each([&](const uint32_t codePoint)
+			CodePointReverseIterator{ self }.each([&](const uint32_t codePoint)
 			{
 				for (auto c : codePoints)
 				{
@@ -190,6 +293,69 @@ namespace CSTM {
 			return result;
 		}
 
+	protected:
+		// NOTE(Peter): String literals include their null terminator, which we don't want to compare against
+		[[nodiscard]]
+		static size_t char_count(const std::ranges::contiguous_range auto& chars) noexcept
+		{
+			const size_t charCount = std::ranges::size(chars);
+			return charCount > 0 && chars[charCount - 1] == '\0' ? charCount - 1 : charCount;
+		}
+
+		[[nodiscard]]
+		static ByteSet make_byte_set(const std::ranges::contiguous_range auto& chars) noexcept
+		{
+			return ByteSet{ reinterpret_cast<const byte*>(std::ranges::data(chars)), char_count(chars) };
+		}
+
+		// Decodes the code point that starts at offset, or returns Null if offset is past the end
+		[[nodiscard]]
+		static Result<uint32_t, NullType> decode_code_point_at(const byte* bytes, size_t byteCount, size_t offset) noexcept
+		{
+			uint32_t codePoint = 0;
+
+			if (offset >= byteCount || decode_utf8(bytes + offset, byteCount - offset, &codePoint, 1).code_point_count == 0)
+			{
+				return Null;
+			}
+
+			return codePoint;
+		}
+
+	};
+
+	template<typename T>
+	concept StringType = std::derived_from<T, StringBase> && requires(const T& str)
+	{
+		{ str.data() } -> std::same_as<const byte*>;
+		{ str.byte_count() } -> std::same_as<size_t>;
+	};
+
+	/*
+	 * Transparent hasher for String and StringView, anything that represents the same bytes hashes the same.
+	 * This allows looking up e.g HashMap<String, T> with a StringView or a std::string_view without creating a String.
+	 */
+	struct StringHash
+	{
+		using is_transparent = void;
+		using is_avalanching = void;
+
+		size_t operator()(const StringType auto& str, uint64_t seed = 0) const noexcept
+		{
+			return hash_bytes(str.data(), str.byte_count(), seed);
+		}
+
+		size_t operator()(std::string_view str, uint64_t seed = 0) const noexcept
+		{
+			return hash_bytes(str.data(), str.length(), seed);
+		}
+
+		template<typename T>
+			requires(std::same_as<T, Span<byte>>)
+		size_t operator()(const T& bytes, uint64_t seed = 0) const noexcept
+		{
+			return hash_bytes(bytes.begin(), bytes.byte_count(), seed);
+		}
 	};
 
 }
@@ -0,0 +1,553 @@
+#include "StringSearch.hpp"
+#include "SIMD.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace CSTM {
+
+	// Needles longer than this use Two-Way, shorter ones the block filter
+	static constexpr size_t LongNeedleLength = 32;
+
+	// Indexes the bytes back to front if Reverse is set, which turns Two-Way into a search for the last occurrence
+	template<bool Reverse>
+	struct SearchBytes
+	{
+		const byte* data;
+		size_t length;
+
+		[[nodiscard]]
+		byte operator[](size_t index) const noexcept
+		{
+			if constexpr (Reverse)
+			{
+				return data[length - 1 - index];
+			}
+			else
+			{
+				return data[index];
+			}
+		}
+	};
+
+	// Returns the offset of the last occurrence of value in bytes, or NotFound
+	static size_t rfind_byte(const byte* bytes, size_t byteCount, byte value) noexcept
+	{
+		size_t end = byteCount;
+
+#if defined(CSTM_SIMD_SSE2)
+		const auto needle = ByteBlock::splat(value);
+
+		while (end >= ByteBlock::Width)
+		{
+			const size_t base = end - ByteBlock::Width;
+
+			if (const uint32_t mask = ByteBlock::load(bytes + base).match(needle); mask != 0)
+			{
+				return base + std::bit_width(mask) - 1;
+			}
+
+			end = base;
+		}
+#endif
+
+		while (end > 0)
+		{
+			if (bytes[--end] == value)
+			{
+				return end;
+			}
+		}
+
+		return NotFound;
+	}
+
+	// NOTE(Peter): Requires 2 <= needleLength <= haystackLength
+	static size_t find_short(const byte* haystack, size_t haystackLength, const byte* needle, size_t needleLength) noexcept
+	{
+		// Every offset up to and including lastOffset could be the start of a match
+		const size_t lastOffset = haystackLength - needleLength;
+		size_t offset = 0;
+
+#if defined(CSTM_SIMD_SSE2)
+		const auto first = ByteBlock::splat(needle[0]);
+		const auto last = ByteBlock::splat(needle[needleLength - 1]);
+
+		for (; offset + ByteBlock::Width <= lastOffset + 1; offset += ByteBlock::Width)
+		{
+			uint32_t mask = ByteBlock::load(haystack + offset).match(first) & ByteBlock::load(haystack + offset + needleLength - 1).match(last);
+
+			while (mask != 0)
+			{
+				const size_t candidate = offset + std::countr_zero(mask);
+
+				if (std::memcmp(haystack + candidate + 1, needle + 1, needleLength - 2) == 0)
+				{
+					return candidate;
+				}
+
+				mask &= mask - 1;
+			}
+		}
+#endif
+
+		// Whatever is left (or everything without SIMD), memchr skips ahead to the next occurrence of the first byte
+		while (offset <= lastOffset)
+		{
+			const void* next = std::memchr(haystack + offset, needle[0], lastOffset - offset + 1);
+
+			if (next == nullptr)
+			{
+				return NotFound;
+			}
+
+			offset = static_cast<const byte*>(next) - haystack;
+
+			if (std::memcmp(haystack + offset + 1, needle + 1, needleLength - 1) == 0)
+			{
+				return offset;
+			}
+
+			offset++;
+		}
+
+		return NotFound;
+	}
+
+	// NOTE(Peter): Requires 2 <= needleLength <= haystackLength
+	static size_t rfind_short(const byte* haystack, size_t haystackLength, const byte* needle, size_t needleLength) noexcept
+	{
+		// Offsets before end haven't been checked yet
+		size_t end = haystackLength - needleLength + 1;
+
+#if defined(CSTM_SIMD_SSE2)
+		const auto first = ByteBlock::splat(needle[0]);
+		const auto last = ByteBlock::splat(needle[needleLength - 1]);
+
+		while (end >= ByteBlock::Width)
+		{
+			const size_t base = end - ByteBlock::Width;
+			uint32_t mask = ByteBlock::load(haystack + base).match(first) & ByteBlock::load(haystack + base + needleLength - 1).match(last);
+
+			while (mask != 0)
+			{
+				const uint32_t bit = std::bit_width(mask) - 1;
+
+				if (std::memcmp(haystack + base + bit + 1, needle + 1, needleLength - 2) == 0)
+				{
+					return base + bit;
+				}
+
+				mask &= ~(1u << bit);
+			}
+
+			end = base;
+		}
+#endif
+
+		while (end > 0)
+		{
+			end--;
+
+			if (haystack[end] == needle[0] && std::memcmp(haystack + end + 1, needle + 1, needleLength - 1) == 0)
+			{
+				return end;
+			}
+		}
+
+		return NotFound;
+	}
+
+	/*
+	 * Computes the maximal suffix of needle, using the regular byte order or the inverted one.
+	 * Returns the offset of the suffix minus one (wrapping around if the suffix is the whole needle), and its period in outPeriod.
+	 */
+	template<bool Reverse>
+	static size_t maximal_suffix(SearchBytes<Reverse> needle, bool invertOrder, size_t& outPeriod) noexcept
+	{
+		size_t suffix = ~size_t{ 0 };
+		size_t j = 0;
+		size_t k = 1;
+		size_t period = 1;
+
+		while (j + k < needle.length)
+		{
+			const byte a = needle[j + k];
+			const byte b = needle[suffix + k];
+
+			if (invertOrder ? a > b : a < b)
+			{
+				j += k;
+				k = 1;
+				period = j - suffix;
+			}
+			else if (a == b)
+			{
+				if (k != period)
+				{
+					k++;
+				}
+				else
+				{
+					j += period;
+					k = 1;
+				}
+			}
+			else
+			{
+				suffix = j++;
+				k = period = 1;
+			}
+		}
+
+		outPeriod = period;
+		return suffix;
+	}
+
+	/*
+	 * Two-Way string matching (Crochemore & Perrin), combined with a shift table for the last byte of the needle
+	 * that lets us skip ahead by up to the length of the needle where the text doesn't look like the needle at all.
+	 * The needle is split at its critical factorization into a left and a right half, the right half is compared first,
+	 * and the period of the needle tells us how far we can shift after a mismatch.
+	 * NOTE(Peter): Requires 2 <= needleLength <= haystackLength, returns an offset into haystack as it's indexed
+	 */
+	template<bool Reverse>
+	static size_t two_way_search(SearchBytes<Reverse> haystack, SearchBytes<Reverse> needle) noexcept
+	{
+		const size_t needleLength = needle.length;
+
+		size_t period = 0;
+		size_t invertedPeriod = 0;
+		const size_t suffix = maximal_suffix(needle, false, period);
+		const size_t invertedSuffix = maximal_suffix(needle, true, invertedPeriod);
+
+		// NOTE(Peter): Comparing with + 1 since both of them can be ~0
+		size_t split = suffix + 1;
+
+		if (suffix + 1 < invertedSuffix + 1)
+		{
+			split = invertedSuffix + 1;
+			period = invertedPeriod;
+		}
+
+		std::array<size_t, 256> shifts;
+		shifts.fill(needleLength);
+
+		for (size_t i = 0; i < needleLength; i++)
+		{
+			shifts[needle[i]] = needleLength - i - 1;
+		}
+
+		bool isPeriodic = true;
+
+		for (size_t i = 0; i < split && isPeriodic; i++)
+		{
+			isPeriodic = needle[i] == needle[i + period];
+		}
+
+		size_t offset = 0;
+
+		if (isPeriodic)
+		{
+			// The left half occurs again one period later, memory is how much of it we already know matches after shifting by the period
+			size_t memory = 0;
+
+			while (offset <= haystack.length - needleLength)
+			{
+				if (size_t shift = shifts[haystack[offset + needleLength - 1]]; shift > 0)
+				{
+					if (memory != 0 && shift < period)
+					{
+						shift = needleLength - period;
+					}
+
+					memory = 0;
+					offset += shift;
+					continue;
+				}
+
+				size_t i = std::max(split, memory);
+
+				while (i < needleLength - 1 && needle[i] == haystack[offset + i])
+				{
+					i++;
+				}
+
+				if (i < needleLength - 1)
+				{
+					offset += i - split + 1;
+					memory = 0;
+					continue;
+				}
+
+				i = split - 1;
+
+				while (memory < i + 1 && needle[i] == haystack[offset + i])
+				{
+					i--;
+				}
+
+				if (i + 1 < memory + 1)
+				{
+					return offset;
+				}
+
+				offset += period;
+				memory = needleLength - period;
+			}
+		}
+		else
+		{
+			// No overlap, we can shift by at least the length of the longer half
+			period = std::max(split, needleLength - split) + 1;
+
+			while (offset <= haystack.length - needleLength)
+			{
+				if (const size_t shift = shifts[haystack[offset + needleLength - 1]]; shift > 0)
+				{
+					offset += shift;
+					continue;
+				}
+
+				size_t i = split;
+
+				while (i < needleLength - 1 && needle[i] == haystack[offset + i])
+				{
+					i++;
+				}
+
+				if (i < needleLength - 1)
+				{
+					offset += i - split + 1;
+					continue;
+				}
+
+				i = split - 1;
+
+				while (i != ~size_t{ 0 } && needle[i] == haystack[offset + i])
+				{
+					i--;
+				}
+
+				if (i == ~size_t{ 0 })
+				{
+					return offset;
+				}
+
+				offset += period;
+			}
+		}
+
+		return NotFound;
+	}
+
+#if defined(CSTM_SIMD_SSSE3)
+	// Classifies a whole ByteBlock against a ByteSet, yielding one bit per byte that's in the set
+	class ByteSetClassifier
+	{
+	public:
+		static constexpr uint32_t FullMask = ByteBlock::Width == 32 ? ~0u : (1u << ByteBlock::Width) - 1;
+
+	#if defined(CSTM_SIMD_AVX2)
+		explicit ByteSetClassifier(const byte (&nibbles)[2][16]) noexcept
+			: m_low(_mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(nibbles[0])))),
+			  m_high(_mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(nibbles[1])))),
+			  m_bits(_mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0)))
+		{}
+
+		[[nodiscard]]
+		uint32_t match(const byte* bytes) const noexcept
+		{
+			const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+
+			// NOTE(Peter): Shuffling yields 0 for indices with the high bit set, so every byte only finds its row in one of the tables
+			const __m256i index = _mm256_and_si256(block, _mm256_set1_epi8(static_cast<char>(0x8F)));
+			const __m256i row = _mm256_or_si256(_mm256_shuffle_epi8(m_low, index), _mm256_shuffle_epi8(m_high, _mm256_xor_si256(index, _mm256_set1_epi8(static_cast<char>(0x80)))));
+			const __m256i bit = _mm256_shuffle_epi8(m_bits, _mm256_and_si256(_mm256_srli_epi16(block, 4), _mm256_set1_epi8(0x07)));
+			return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit)));
+		}
+
+	private:
+		__m256i m_low;
+		__m256i m_high;
+		__m256i m_bits;
+	#else
+		explicit ByteSetClassifier(const byte (&nibbles)[2][16]) noexcept
+			: m_low(_mm_load_si128(reinterpret_cast<const __m128i*>(nibbles[0]))),
+			  m_high(_mm_load_si128(reinterpret_cast<const __m128i*>(nibbles[1]))),
+			  m_bits(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0))
+		{}
+
+		[[nodiscard]]
+		uint32_t match(const byte* bytes) const noexcept
+		{
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+
+			// NOTE(Peter): Shuffling yields 0 for indices with the high bit set, so every byte only finds its row in one of the tables
+			const __m128i index = _mm_and_si128(block, _mm_set1_epi8(static_cast<char>(0x8F)));
+			const __m128i row = _mm_or_si128(_mm_shuffle_epi8(m_low, index), _mm_shuffle_epi8(m_high, _mm_xor_si128(index, _mm_set1_epi8(static_cast<char>(0x80)))));
+			const __m128i bit = _mm_shuffle_epi8(m_bits, _mm_and_si128(_mm_srli_epi16(block, 4), _mm_set1_epi8(0x07)));
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit)));
+		}
+
+	private:
+		__m128i m_low;
+		__m128i m_high;
+		__m128i m_bits;
+	#endif
+	};
+#endif
+
+	ByteSet::ByteSet(const byte* bytes, size_t byteCount) noexcept
+	{
+		for (size_t i = 0; i < byteCount; i++)
+		{
+			insert(bytes[i]);
+		}
+	}
+
+	void ByteSet::insert(byte value) noexcept
+	{
+		m_bits[value >> 6] |= uint64_t{ 1 } << (value & 63);
+		m_nibbles[value >> 7][value & 0x0F] |= static_cast<byte>(1 << ((value >> 4) & 0x07));
+	}
+
+	size_t ByteSet::find_first_in(const byte* bytes, size_t byteCount) const noexcept
+	{
+		return find_first<true>(bytes, byteCount);
+	}
+
+	size_t ByteSet::find_first_not_in(const byte* bytes, size_t byteCount) const noexcept
+	{
+		return find_first<false>(bytes, byteCount);
+	}
+
+	size_t ByteSet::find_last_in(const byte* bytes, size_t byteCount) const noexcept
+	{
+		return find_last<true>(bytes, byteCount);
+	}
+
+	size_t ByteSet::find_last_not_in(const byte* bytes, size_t byteCount) const noexcept
+	{
+		return find_last<false>(bytes, byteCount);
+	}
+
+	template<bool InSet>
+	size_t ByteSet::find_first(const byte* bytes, size_t byteCount) const noexcept
+	{
+		size_t offset = 0;
+
+#if defined(CSTM_SIMD_SSSE3)
+		const ByteSetClassifier classifier(m_nibbles);
+
+		for (; offset + ByteBlock::Width <= byteCount; offset += ByteBlock::Width)
+		{
+			const uint32_t mask = InSet ? classifier.match(bytes + offset) : ~classifier.match(bytes + offset) & ByteSetClassifier::FullMask;
+
+			if (mask != 0)
+			{
+				return offset + std::countr_zero(mask);
+			}
+		}
+#endif
+
+		for (; offset < byteCount; offset++)
+		{
+			if (contains(bytes[offset]) == InSet)
+			{
+				return offset;
+			}
+		}
+
+		return NotFound;
+	}
+
+	template<bool InSet>
+	size_t ByteSet::find_last(const byte* bytes, size_t byteCount) const noexcept
+	{
+		size_t end = byteCount;
+
+#if defined(CSTM_SIMD_SSSE3)
+		const ByteSetClassifier classifier(m_nibbles);
+
+		while (end >= ByteBlock::Width)
+		{
+			const size_t base = end - ByteBlock::Width;
+			const uint32_t mask = InSet ? classifier.match(bytes + base) : ~classifier.match(bytes + base) & ByteSetClassifier::FullMask;
+
+			if (mask != 0)
+			{
+				return base + std::bit_width(mask) - 1;
+			}
+
+			end = base;
+		}
+#endif
+
+		while (end > 0)
+		{
+			if (contains(bytes[--end]) == InSet)
+			{
+				return end;
+			}
+		}
+
+		return NotFound;
+	}
+
+	size_t find_bytes(const byte* haystack, size_t haystackLength, const byte* needle, size_t needleLength) noexcept
+	{
+		if (needleLength == 0)
+		{
+			return 0;
+		}
+
+		if (needleLength > haystackLength)
+		{
+			return NotFound;
+		}
+
+		if (needleLength == 1)
+		{
+			const void* result = std::memchr(haystack, needle[0], haystackLength);
+			return result != nullptr ? static_cast<const byte*>(result) - haystack : NotFound;
+		}
+
+		if (needleLength <= LongNeedleLength)
+		{
+			return find_short(haystack, haystackLength, needle, needleLength);
+		}
+
+		return two_way_search(SearchBytes<false>{ haystack, haystackLength }, SearchBytes<false>{ needle, needleLength });
+	}
+
+	size_t rfind_bytes(const byte* haystack, size_t haystackLength, const byte* needle, size_t needleLength) noexcept
+	{
+		if (needleLength == 0)
+		{
+			return haystackLength;
+		}
+
+		if (needleLength > haystackLength)
+		{
+			return NotFound;
+		}
+
+		if (needleLength == 1)
+		{
+			return rfind_byte(haystack, haystackLength, needle[0]);
+		}
+
+		if (needleLength <= LongNeedleLength)
+		{
+			return rfind_short(haystack, haystackLength, needle, needleLength);
+		}
+
+		// NOTE(Peter): Searching the reversed haystack for the reversed needle finds the last occurrence first
+		const size_t offset = two_way_search(SearchBytes<true>{ haystack, haystackLength }, SearchBytes<true>{ needle, needleLength });
+		return offset != NotFound ? haystackLength - offset - needleLength : NotFound;
+	}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CSTM {
+
+	// Returned by the searching functions when nothing was found
+	inline constexpr size_t NotFound = ~size_t{ 0 };
+
+	/*
+	 * Returns the offset of the first occurrence of needle in haystack, or NotFound. An empty needle is found at offset 0.
+	 * Short needles are searched for by comparing the first and last byte of the needle against a whole block of the haystack
+	 * at once (see ByteBlock), and only comparing the rest of the needle where both of them match.
+	 * Long needles use the Two-Way algorithm instead, which never looks at a byte of the haystack more than twice,
+	 * no matter how many partial matches there are.
+	 */
+	[[nodiscard]]
+	size_t find_bytes(const byte* haystack, size_t haystackLength, const byte* needle, size_t needleLength) noexcept;
+
+	// Same as find_bytes, but returns the offset of the last occurrence. An empty needle is found at haystackLength.
+	[[nodiscard]]
+	size_t rfind_bytes(const byte* haystack, size_t haystackLength, const byte* needle, size_t needleLength) noexcept;
+
+	/*
+	 * Set of byte values, built once and then used to search for the first (or last) byte that is or isn't in the set.
+	 * With SSSE3 (or AVX2) a whole ByteBlock is classified at once, using the low nibble of every byte to look up
+	 * which high nibbles are in the set, which makes searching independent of the number of bytes in the set.
+	 */
+	class ByteSet
+	{
+	public:
+		ByteSet() noexcept = default;
+		ByteSet(const byte* bytes, size_t byteCount) noexcept;
+
+		void insert(byte value) noexcept;
+
+		[[nodiscard]]
+		bool contains(byte value) const noexcept { return (m_bits[value >> 6] >> (value & 63)) & 1; }
+
+		// These return the offset of the first (or last) byte that is (or isn't) in the set, or NotFound
+		[[nodiscard]]
+		size_t find_first_in(const byte* bytes, size_t byteCount) const noexcept;
+
+		[[nodiscard]]
+		size_t find_first_not_in(const byte* bytes, size_t byteCount) const noexcept;
+
+		[[nodiscard]]
+		size_t find_last_in(const byte* bytes, size_t byteCount) const noexcept;
+
+		[[nodiscard]]
+		size_t find_last_not_in(const byte* bytes, size_t byteCount) const noexcept;
+
+	private:
+		template<bool InSet>
+		[[nodiscard]]
+		size_t find_first(const byte* bytes, size_t byteCount) const noexcept;
+
+		template<bool InSet>
+		[[nodiscard]]
+		size_t find_last(const byte* bytes, size_t byteCount) const noexcept;
+
+	private:
+		uint64_t m_bits[4]{};
+
+		// NOTE(Peter): Bit n of m_nibbles[0][low] is set if the byte (n << 4 | low) is in the set, m_nibbles[1] covers bytes >= 0x80
+		alignas(16) byte m_nibbles[2][16]{};
+	};
+
+}
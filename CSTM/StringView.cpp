@@ -13,12 +13,6 @@ namespace CSTM {
 		: m_data(data), m_byte_count(byteCount)
 	{}
 
-	StringView::~StringView() noexcept
-	{
-		m_data = nullptr;
-		m_byte_count = 0;
-	}
-
 	bool StringView::operator==(StringView other) const noexcept
 	{
 		if (this == &other || m_data == other.m_data)
@@ -44,4 +38,24 @@ namespace CSTM {
 		return std::equal(m_data, m_data + m_byte_count, str);
 	}
 
+	bool StringView::operator==(std::string_view str) const noexcept
+	{
+		if (str.length() != m_byte_count)
+		{
+			return false;
+		}
+
+		return std::equal(m_data, m_data + m_byte_count, reinterpret_cast<const byte*>(str.data()));
+	}
+
+	bool StringView::operator==(Span<byte> bytes) const noexcept
+	{
+		if (bytes.count() != m_byte_count)
+		{
+			return false;
+		}
+
+		return std::equal(m_data, m_data + m_byte_count, bytes.begin());
+	}
+
 }
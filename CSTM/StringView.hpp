@@ -2,19 +2,21 @@
 
 #include "Types.hpp"
 #include "StringBase.hpp"
+#include "Span.hpp"
 
 #include <cstddef>
+#include <string_view>
 
 namespace CSTM {
 
 	class String;
 
+	// NOTE(Peter): Just a pointer and a byte count, cheap enough to pass by value
 	class StringView : public StringBase
 	{
 	public:
 		StringView() noexcept;
 		StringView(const byte* data, size_t byteCount) noexcept;
-		~StringView() noexcept override;
 
 	public:
 		[[nodiscard]]
@@ -23,14 +25,20 @@ namespace CSTM {
 		[[nodiscard]]
 		bool operator==(const char* str) const noexcept;
 
+		[[nodiscard]]
+		bool operator==(std::string_view str) const noexcept;
+
+		[[nodiscard]]
+		bool operator==(Span<byte> bytes) const noexcept;
+
 		[[nodiscard]]
 		bool is_empty() const noexcept { return m_byte_count == 0; }
 
 		[[nodiscard]]
-		const byte* data() const noexcept override { return m_data; }
+		const byte* data() const noexcept { return m_data; }
 
 		[[nodiscard]]
-		size_t byte_count() const noexcept override { return m_byte_count; }
+		size_t byte_count() const noexcept { return m_byte_count; }
 
 	private:
 		const byte* m_data;
@@ -38,3 +46,6 @@ namespace CSTM {
 	};
 
 }
+
+template<>
+struct std::hash<CSTM::StringView> : CSTM::StringHash {};
@@ -0,0 +1,554 @@
+#include "Unicode.hpp"
+#include "SIMD.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace CSTM {
+
+#if defined(CSTM_SIMD_SSE2)
+	// Widens ByteBlock::Width ASCII bytes to code points
+	static void widen_ascii(const byte* bytes, uint32_t* outCodePoints) noexcept
+	{
+	#if defined(CSTM_SIMD_AVX2)
+		for (size_t i = 0; i < ByteBlock::Width; i += 8)
+		{
+			const __m128i eightBytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes + i));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(outCodePoints + i), _mm256_cvtepu8_epi32(eightBytes));
+		}
+	#else
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i low = _mm_unpacklo_epi8(block, zero);
+		const __m128i high = _mm_unpackhi_epi8(block, zero);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outCodePoints), _mm_unpacklo_epi16(low, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outCodePoints + 4), _mm_unpackhi_epi16(low, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outCodePoints + 8), _mm_unpacklo_epi16(high, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outCodePoints + 12), _mm_unpackhi_epi16(high, zero));
+	#endif
+	}
+#endif
+
+#if defined(CSTM_SIMD_SSSE3)
+	// Decodes 4 code points if the first 12 of the 16 bytes are 4 valid three byte sequences (e.g most CJK text), returns false otherwise
+	static bool decode_three_byte_sequences(const byte* bytes, uint32_t* outCodePoints) noexcept
+	{
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+
+		// Leading bytes have to be 0b1110'xxxx, trailing bytes 0b10xx'xxxx
+		const __m128i prefixMask = _mm_setr_epi8(-16, -64, -64, -16, -64, -64, -16, -64, -64, -16, -64, -64, 0, 0, 0, 0);
+		const __m128i prefixes = _mm_setr_epi8(-32, -128, -128, -32, -128, -128, -32, -128, -128, -32, -128, -128, 0, 0, 0, 0);
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(block, prefixMask), prefixes)) != 0xFFFF)
+		{
+			return false;
+		}
+
+		// Every sequence gets its own 32-bit lane, with the leading byte as the most significant one
+		const __m128i sequences = _mm_shuffle_epi8(block, _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1));
+		const __m128i codePoints = _mm_or_si128(
+			_mm_and_si128(sequences, _mm_set1_epi32(0x003F)),
+			_mm_or_si128(
+				_mm_and_si128(_mm_srli_epi32(sequences, 2), _mm_set1_epi32(0x0FC0)),
+				_mm_and_si128(_mm_srli_epi32(sequences, 4), _mm_set1_epi32(0xF000))
+			)
+		);
+
+		// NOTE(Peter): Overlong encodings and surrogates are left to decode_code_point, which replaces them
+		const __m128i overlong = _mm_cmplt_epi32(codePoints, _mm_set1_epi32(0x800));
+		const __m128i surrogate = _mm_cmpeq_epi32(_mm_and_si128(codePoints, _mm_set1_epi32(0xF800)), _mm_set1_epi32(0xD800));
+
+		if (_mm_movemask_epi8(_mm_or_si128(overlong, surrogate)) != 0)
+		{
+			return false;
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outCodePoints), codePoints);
+		return true;
+	}
+
+	// Decodes 4 code points if the first 8 of the 16 bytes are 4 valid two byte sequences (e.g Cyrillic or Greek), returns false otherwise
+	static bool decode_two_byte_sequences(const byte* bytes, uint32_t* outCodePoints) noexcept
+	{
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+
+		// Leading bytes have to be 0b110x'xxxx, trailing bytes 0b10xx'xxxx
+		const __m128i prefixMask = _mm_setr_epi8(-32, -64, -32, -64, -32, -64, -32, -64, 0, 0, 0, 0, 0, 0, 0, 0);
+		const __m128i prefixes = _mm_setr_epi8(-64, -128, -64, -128, -64, -128, -64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(block, prefixMask), prefixes)) != 0xFFFF)
+		{
+			return false;
+		}
+
+		const __m128i sequences = _mm_shuffle_epi8(block, _mm_setr_epi8(1, 0, -1, -1, 3, 2, -1, -1, 5, 4, -1, -1, 7, 6, -1, -1));
+		const __m128i codePoints = _mm_or_si128(
+			_mm_and_si128(sequences, _mm_set1_epi32(0x003F)),
+			_mm_and_si128(_mm_srli_epi32(sequences, 2), _mm_set1_epi32(0x07C0))
+		);
+
+		// NOTE(Peter): Overlong encodings (C0 and C1 leading bytes) are left to decode_code_point, which replaces them
+		if (_mm_movemask_epi8(_mm_cmplt_epi32(codePoints, _mm_set1_epi32(0x80))) != 0)
+		{
+			return false;
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outCodePoints), codePoints);
+		return true;
+	}
+#endif
+
+	// Decodes a single code point, returns how many bytes it took up
+	static size_t decode_code_point(const byte* bytes, size_t byteCount, uint32_t& outCodePoint) noexcept
+	{
+		const byte leadingByte = bytes[0];
+
+		if (leadingByte < 0x80)
+		{
+			outCodePoint = leadingByte;
+			return 1;
+		}
+
+		// NOTE(Peter): Invalid sequences only consume their first byte, that way we resynchronize at the next leading byte
+		outCodePoint = ReplacementCodePoint;
+
+		const size_t sequenceLength = std::countl_one(leadingByte);
+
+		if (sequenceLength < 2 || sequenceLength > 4 || sequenceLength > byteCount)
+		{
+			return 1;
+		}
+
+		uint32_t codePoint = leadingByte & (0x7F >> sequenceLength);
+
+		for (size_t i = 1; i < sequenceLength; i++)
+		{
+			if ((bytes[i] & 0xC0) != 0x80)
+			{
+				return 1;
+			}
+
+			codePoint = (codePoint << 6) | (bytes[i] & 0x3F);
+		}
+
+		// Overlong encodings (e.g C0 AF for '/'), surrogates and anything above U+10FFFF aren't valid either
+		static constexpr uint32_t MinCodePoints[] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+		if (codePoint < MinCodePoints[sequenceLength] || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+		{
+			return 1;
+		}
+
+		outCodePoint = codePoint;
+		return sequenceLength;
+	}
+
+#if defined(CSTM_SIMD_SSSE3)
+	/*
+	 * Validates UTF-8 16 bytes at a time using lookup tables (Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte").
+	 * Every pair of adjacent bytes is classified by the high nibble of the first byte, the low nibble of the first byte
+	 * and the high nibble of the second byte. Each lookup yields the set of errors the pair could be part of,
+	 * and the pair is invalid if all three of them agree on at least one error.
+	 */
+	class Utf8Validator
+	{
+		static constexpr uint8_t TooShort = 1 << 0;		// 11______ 0_______ or 11______ 11______
+		static constexpr uint8_t TooLong = 1 << 1;		// 0_______ 10______
+		static constexpr uint8_t Overlong3 = 1 << 2;	// 11100000 100_____
+		static constexpr uint8_t TooLarge = 1 << 3;		// 11110100 1001____ and above
+		static constexpr uint8_t Surrogate = 1 << 4;	// 11101101 101_____
+		static constexpr uint8_t Overlong2 = 1 << 5;	// 1100000_ 10______
+		static constexpr uint8_t TooLarge1000 = 1 << 6;	// 11110101 1000____ and above
+		static constexpr uint8_t Overlong4 = 1 << 6;	// 11110000 1000____
+		static constexpr uint8_t TwoContinuations = 1 << 7;	// 10______ 10______
+
+		// NOTE(Peter): These have no bits in the low nibble of the first byte that matter
+		static constexpr uint8_t Carry = TooShort | TooLong | TwoContinuations;
+
+	public:
+		void check_block(__m128i block) noexcept
+		{
+			if (_mm_movemask_epi8(block) == 0)
+			{
+				// ASCII can't continue a sequence from the previous block
+				m_error = _mm_or_si128(m_error, m_previous_incomplete);
+				m_previous_incomplete = _mm_setzero_si128();
+			}
+			else
+			{
+				const __m128i previous1 = _mm_alignr_epi8(block, m_previous, 15);
+				const __m128i errors = check_special_cases(block, previous1);
+				m_error = _mm_or_si128(m_error, _mm_xor_si128(errors, must_be_continuation(block)));
+				m_previous_incomplete = is_incomplete(block);
+			}
+
+			m_previous = block;
+		}
+
+		// Checks whether the last block ended in the middle of a sequence, returns true if everything was valid
+		[[nodiscard]]
+		bool finish() noexcept
+		{
+			m_error = _mm_or_si128(m_error, m_previous_incomplete);
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(m_error, _mm_setzero_si128())) == 0xFFFF;
+		}
+
+	private:
+		[[nodiscard]]
+		static __m128i high_nibbles(__m128i v) noexcept { return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F)); }
+
+		[[nodiscard]]
+		static __m128i check_special_cases(__m128i block, __m128i previous1) noexcept
+		{
+			const __m128i byte1High = _mm_shuffle_epi8(_mm_setr_epi8(
+				// 0_______ ________ (ASCII)
+				TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+				// 10______ ________ (continuation)
+				TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,
+				// 1100____ ________ (two byte lead)
+				TooShort | Overlong2,
+				// 1101____ ________ (two byte lead)
+				TooShort,
+				// 1110____ ________ (three byte lead)
+				TooShort | Overlong3 | Surrogate,
+				// 1111____ ________ (four byte lead)
+				static_cast<char>(TooShort | TooLarge | TooLarge1000 | Overlong4)
+			), high_nibbles(previous1));
+
+			const __m128i byte1Low = _mm_shuffle_epi8(_mm_setr_epi8(
+				// ____0000 ________
+				static_cast<char>(Carry | Overlong3 | Overlong2 | Overlong4),
+				// ____0001 ________
+				static_cast<char>(Carry | Overlong2),
+				// ____001_ ________
+				static_cast<char>(Carry), static_cast<char>(Carry),
+				// ____0100 ________
+				static_cast<char>(Carry | TooLarge),
+				// ____0101 ________ and above
+				static_cast<char>(Carry | TooLarge | TooLarge1000), static_cast<char>(Carry | TooLarge | TooLarge1000),
+				static_cast<char>(Carry | TooLarge | TooLarge1000), static_cast<char>(Carry | TooLarge | TooLarge1000),
+				static_cast<char>(Carry | TooLarge | TooLarge1000), static_cast<char>(Carry | TooLarge | TooLarge1000),
+				static_cast<char>(Carry | TooLarge | TooLarge1000), static_cast<char>(Carry | TooLarge | TooLarge1000),
+				// ____1101 ________
+				static_cast<char>(Carry | TooLarge | TooLarge1000 | Surrogate),
+				static_cast<char>(Carry | TooLarge | TooLarge1000), static_cast<char>(Carry | TooLarge | TooLarge1000)
+			), _mm_and_si128(previous1, _mm_set1_epi8(0x0F)));
+
+			const __m128i byte2High = _mm_shuffle_epi8(_mm_setr_epi8(
+				// ________ 0_______ (ASCII)
+				TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+				// ________ 1000____
+				static_cast<char>(TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4),
+				// ________ 1001____
+				static_cast<char>(TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge),
+				// ________ 101_____
+				static_cast<char>(TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge),
+				static_cast<char>(TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge),
+				// ________ 11______ (lead)
+				TooShort, TooShort, TooShort, TooShort
+			), high_nibbles(block));
+
+			return _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+		}
+
+		// Marks the bytes that have to be the third or fourth byte of a sequence, these are expected to show up as TwoContinuations
+		[[nodiscard]]
+		__m128i must_be_continuation(__m128i block) const noexcept
+		{
+			const __m128i previous2 = _mm_alignr_epi8(block, m_previous, 14);
+			const __m128i previous3 = _mm_alignr_epi8(block, m_previous, 13);
+
+			// NOTE(Peter): Only 111_____ and 1111____ end up with the high bit set after subtracting
+			const __m128i isThirdByte = _mm_subs_epu8(previous2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+			const __m128i isFourthByte = _mm_subs_epu8(previous3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+			return _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte), _mm_set1_epi8(static_cast<char>(0x80)));
+		}
+
+		// Non-zero if the block ends in the middle of a sequence
+		[[nodiscard]]
+		static __m128i is_incomplete(__m128i block) noexcept
+		{
+			const __m128i maxValues = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+			return _mm_subs_epu8(block, maxValues);
+		}
+
+	private:
+		__m128i m_error = _mm_setzero_si128();
+		__m128i m_previous = _mm_setzero_si128();
+		__m128i m_previous_incomplete = _mm_setzero_si128();
+	};
+#else
+	// Validates a single sequence according to the Unicode standard (Table 3-7), returns its length or 0 if it's invalid
+	static size_t validate_sequence(const byte* bytes, size_t byteCount) noexcept
+	{
+		const byte leadingByte = bytes[0];
+
+		if (leadingByte < 0x80)
+		{
+			return 1;
+		}
+
+		// NOTE(Peter): The second byte has a narrower range right after some leading bytes, this rules out overlong encodings,
+		//				surrogates and anything above U+10FFFF
+		byte secondMin = 0x80;
+		byte secondMax = 0xBF;
+		size_t sequenceLength = 0;
+
+		if (leadingByte >= 0xC2 && leadingByte <= 0xDF)
+		{
+			sequenceLength = 2;
+		}
+		else if (leadingByte >= 0xE0 && leadingByte <= 0xEF)
+		{
+			sequenceLength = 3;
+			secondMin = leadingByte == 0xE0 ? 0xA0 : 0x80;
+			secondMax = leadingByte == 0xED ? 0x9F : 0xBF;
+		}
+		else if (leadingByte >= 0xF0 && leadingByte <= 0xF4)
+		{
+			sequenceLength = 4;
+			secondMin = leadingByte == 0xF0 ? 0x90 : 0x80;
+			secondMax = leadingByte == 0xF4 ? 0x8F : 0xBF;
+		}
+
+		if (sequenceLength == 0 || sequenceLength > byteCount || bytes[1] < secondMin || bytes[1] > secondMax)
+		{
+			return 0;
+		}
+
+		for (size_t i = 2; i < sequenceLength; i++)
+		{
+			if ((bytes[i] & 0xC0) != 0x80)
+			{
+				return 0;
+			}
+		}
+
+		return sequenceLength;
+	}
+#endif
+
+	bool validate_utf8(const byte* bytes, size_t byteCount) noexcept
+	{
+#if defined(CSTM_SIMD_SSSE3)
+		Utf8Validator validator;
+		size_t offset = 0;
+
+		for (; offset + 16 <= byteCount; offset += 16)
+		{
+			validator.check_block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset)));
+		}
+
+		// NOTE(Peter): The rest is padded with zeros, which are ASCII and can't hide an incomplete sequence
+		if (offset < byteCount)
+		{
+			alignas(16) byte lastBlock[16]{};
+			std::memcpy(lastBlock, bytes + offset, byteCount - offset);
+			validator.check_block(_mm_load_si128(reinterpret_cast<const __m128i*>(lastBlock)));
+		}
+
+		return validator.finish();
+#else
+		size_t offset = 0;
+
+		while (offset < byteCount)
+		{
+			// Skip 8 bytes at once as long as they're ASCII
+			if (uint64_t eightBytes; byteCount - offset >= 8)
+			{
+				std::memcpy(&eightBytes, bytes + offset, sizeof(eightBytes));
+
+				if ((eightBytes & 0x8080'8080'8080'8080) == 0)
+				{
+					offset += 8;
+					continue;
+				}
+			}
+
+			const size_t sequenceLength = validate_sequence(bytes + offset, byteCount - offset);
+
+			if (sequenceLength == 0)
+			{
+				return false;
+			}
+
+			offset += sequenceLength;
+		}
+
+		return true;
+#endif
+	}
+
+#if defined(CSTM_SIMD_SSE2)
+	// Counts the bytes that aren't trailing bytes in count blocks of ByteBlock::Width bytes
+	static size_t count_leading_bytes(const byte* bytes, size_t blockCount) noexcept
+	{
+		size_t count = 0;
+
+		// NOTE(Peter): Per byte counters are accumulated with a byte wide subtract (a match is -1), and only summed up
+		//				once they could overflow, so the inner loop is just a load, a compare and a subtract.
+		//				Trailing bytes are the only ones below -64 when the bytes are treated as signed.
+		while (blockCount > 0)
+		{
+			const size_t batchCount = std::min<size_t>(blockCount, 255);
+
+		#if defined(CSTM_SIMD_AVX2)
+			const __m256i threshold = _mm256_set1_epi8(-65);
+			__m256i counters = _mm256_setzero_si256();
+
+			for (size_t i = 0; i < batchCount; i++)
+			{
+				const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i * ByteBlock::Width));
+				counters = _mm256_sub_epi8(counters, _mm256_cmpgt_epi8(block, threshold));
+			}
+
+			const __m256i sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+			count += _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) + _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3);
+		#else
+			const __m128i threshold = _mm_set1_epi8(-65);
+			__m128i counters = _mm_setzero_si128();
+
+			for (size_t i = 0; i < batchCount; i++)
+			{
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i * ByteBlock::Width));
+				counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(block, threshold));
+			}
+
+			const __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+			count += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+		#endif
+
+			bytes += batchCount * ByteBlock::Width;
+			blockCount -= batchCount;
+		}
+
+		return count;
+	}
+#endif
+
+	size_t count_code_points(const byte* bytes, size_t byteCount) noexcept
+	{
+		size_t count = 0;
+		size_t offset = 0;
+
+	#if defined(CSTM_SIMD_SSE2)
+		const size_t blockCount = byteCount / ByteBlock::Width;
+		count += count_leading_bytes(bytes, blockCount);
+		offset = blockCount * ByteBlock::Width;
+	#endif
+
+		for (; offset + 8 <= byteCount; offset += 8)
+		{
+			uint64_t eightBytes;
+			std::memcpy(&eightBytes, bytes + offset, sizeof(eightBytes));
+
+			// Trailing bytes have their high bit set, and the bit below it (shifted into the high bit) cleared
+			const uint64_t trailingBytes = eightBytes & ~(eightBytes << 1) & 0x8080'8080'8080'8080;
+			count += 8 - std::popcount(trailingBytes);
+		}
+
+		for (; offset < byteCount; offset++)
+		{
+			count += (bytes[offset] & 0xC0) != 0x80;
+		}
+
+		return count;
+	}
+
+	size_t code_point_offset(const byte* bytes, size_t byteCount, size_t index) noexcept
+	{
+		static constexpr size_t ChunkSize = 256;
+
+		size_t offset = 0;
+
+		for (; offset + ChunkSize <= byteCount; offset += ChunkSize)
+		{
+			const size_t chunkCodePoints = count_code_points(bytes + offset, ChunkSize);
+
+			if (chunkCodePoints > index)
+			{
+				break;
+			}
+
+			index -= chunkCodePoints;
+		}
+
+		for (; offset + 8 <= byteCount; offset += 8)
+		{
+			uint64_t eightBytes;
+			std::memcpy(&eightBytes, bytes + offset, sizeof(eightBytes));
+
+			const uint64_t trailingBytes = eightBytes & ~(eightBytes << 1) & 0x8080'8080'8080'8080;
+			const size_t eightCodePoints = 8 - std::popcount(trailingBytes);
+
+			if (eightCodePoints > index)
+			{
+				break;
+			}
+
+			index -= eightCodePoints;
+		}
+
+		for (; offset < byteCount; offset++)
+		{
+			if ((bytes[offset] & 0xC0) != 0x80 && index-- == 0)
+			{
+				return offset;
+			}
+		}
+
+		return byteCount;
+	}
+
+	Utf8DecodeResult decode_utf8(const byte* bytes, size_t byteCount, uint32_t* outCodePoints, size_t maxCodePointCount) noexcept
+	{
+		size_t offset = 0;
+		size_t codePointCount = 0;
+
+		while (offset < byteCount && codePointCount < maxCodePointCount)
+		{
+#if defined(CSTM_SIMD_SSE2)
+			if (byteCount - offset >= ByteBlock::Width && maxCodePointCount - codePointCount >= ByteBlock::Width)
+			{
+				// Decode the ASCII bytes at the start of the block, which is all of them most of the time
+				const uint32_t nonAsciiMask = ByteBlock::load(bytes + offset).high_bits();
+				const size_t asciiCount = nonAsciiMask != 0 ? std::countr_zero(nonAsciiMask) : ByteBlock::Width;
+
+				if (asciiCount > 0)
+				{
+					widen_ascii(bytes + offset, outCodePoints + codePointCount);
+					offset += asciiCount;
+					codePointCount += asciiCount;
+					continue;
+				}
+			}
+#endif
+
+#if defined(CSTM_SIMD_SSSE3)
+			if (byteCount - offset >= 16 && maxCodePointCount - codePointCount >= 4)
+			{
+				if (decode_three_byte_sequences(bytes + offset, outCodePoints + codePointCount))
+				{
+					offset += 12;
+					codePointCount += 4;
+					continue;
+				}
+
+				if (decode_two_byte_sequences(bytes + offset, outCodePoints + codePointCount))
+				{
+					offset += 8;
+					codePointCount += 4;
+					continue;
+				}
+			}
+#endif
+
+			offset += decode_code_point(bytes + offset, byteCount - offset, outCodePoints[codePointCount++]);
+		}
+
+		return { offset, codePointCount };
+	}
+
+}
@@ -1,13 +1,59 @@
 #pragma once
 
+#include "Assert.hpp"
 #include "Utility.hpp"
 
 #include <array>
 #include <bitset>
+#include <cstddef>
 #include <cstdint>
 
 namespace CSTM {
 
+	// Substituted for bytes that aren't part of a valid UTF-8 sequence
+	inline constexpr uint32_t ReplacementCodePoint = 0xFFFD;
+
+	struct Utf8DecodeResult
+	{
+		size_t byte_count;
+		size_t code_point_count;
+	};
+
+	/*
+	 * Decodes UTF-8 bytes into at most maxCodePointCount code points, only ever stopping in between two code points.
+	 * Returns how many bytes were consumed and how many code points were written to outCodePoints.
+	 * Blocks of ASCII (and runs of 2 or 3 byte sequences with SSSE3) are decoded 16 or 32 bytes at a time,
+	 * anything else one code point at a time. Bytes that don't form a valid sequence decode to ReplacementCodePoint,
+	 * one per byte. Overlong encodings, surrogates and code points above U+10FFFF aren't valid sequences either.
+	 * NOTE(Peter): Never reads past bytes + byteCount, but may write up to 32 code points past the ones it returns
+	 *				as long as they are within maxCodePointCount
+	 */
+	[[nodiscard]]
+	Utf8DecodeResult decode_utf8(const byte* bytes, size_t byteCount, uint32_t* outCodePoints, size_t maxCodePointCount) noexcept;
+
+	/*
+	 * Returns whether bytes are valid UTF-8, rejecting overlong encodings, surrogates, code points above U+10FFFF
+	 * and sequences that are cut short. With SSSE3 (or AVX2) this looks at 16 bytes at a time.
+	 */
+	[[nodiscard]]
+	bool validate_utf8(const byte* bytes, size_t byteCount) noexcept;
+
+	/*
+	 * Counts the code points in bytes without decoding them, by counting every byte that isn't a trailing byte (0b10xx'xxxx).
+	 * Looks at 16 or 32 bytes at a time with SSE2 or AVX2, and 8 bytes at a time otherwise.
+	 * NOTE(Peter): This only matches the number of code points decode_utf8 produces if bytes are valid UTF-8
+	 */
+	[[nodiscard]]
+	size_t count_code_points(const byte* bytes, size_t byteCount) noexcept;
+
+	/*
+	 * Returns the byte offset of the code point at index, counting code points the same way count_code_points does,
+	 * or byteCount if there are only index code points (or fewer). Skips over whole chunks of bytes at a time
+	 * using count_code_points, and only looks at individual bytes in the chunk that contains the code point.
+	 */
+	[[nodiscard]]
+	size_t code_point_offset(const byte* bytes, size_t byteCount, size_t index) noexcept;
+
 	constexpr std::array<byte, 4> utf32_to_utf8(uint32_t codePoint, uint32_t& outCodePointByteCount)
 	{
 		std::array<byte, 4> result{};
@@ -25,6 +25,12 @@ namespace CSTM {
 
 	constexpr NullType Null = NullType{};
 
+	// Returned from iteration callbacks (e.g CodePointIterator::each) to control whether iteration continues
+	enum class IterAction
+	{
+		Break, Continue
+	};
+
 	template<typename Func, typename... Args>
 	constexpr auto conditional_invoke_result()
 	{
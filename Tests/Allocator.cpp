@@ -0,0 +1,76 @@
+#include "Test.hpp"
+
+#include <Allocator.hpp>
+#include <HashMap.hpp>
+#include <String.hpp>
+
+using namespace CSTM;
+
+DeclTest(allocator, arena_allocate_reset)
+{
+	Arena arena(1024);
+
+	void* first = arena.allocate(10, 1);
+	void* aligned = arena.allocate(64, 64);
+	Cond(Eq, reinterpret_cast<uintptr_t>(aligned) % 64, 0);
+	const bool afterFirst = static_cast<byte*>(aligned) >= static_cast<byte*>(first) + 10;
+	Cond(Eq, afterFirst, true);
+
+	// Only the most recent allocation can be reclaimed
+	arena.deallocate(aligned, 64);
+	Cond(Eq, arena.allocate(64, 64), aligned);
+
+	// Larger than a chunk, gets a chunk of its own
+	void* large = arena.allocate(4096, 8);
+	Cond(NotEq, large, nullptr);
+	Cond(NotEq, arena.reserved_byte_count(), 1024);
+
+	// Allocating after the large allocation keeps using the current chunk
+	const ptrdiff_t distance = static_cast<byte*>(arena.allocate(8, 8)) - static_cast<byte*>(aligned);
+	Cond(Eq, distance, 64);
+
+	arena.reset();
+	Cond(Eq, arena.reserved_byte_count(), 1024);
+	Cond(Eq, arena.allocate(10, 1), first);
+}
+
+DeclTest(allocator, arena_hash_map)
+{
+	Arena arena;
+
+	{
+		ArenaHashMap<size_t, size_t> map(arena);
+
+		for (size_t i = 0; i < 1000; i++)
+		{
+			map.insert(i, i * 2);
+		}
+
+		const auto copy = map;
+		Cond(Eq, copy.at(999), 1998);
+		Cond(NotEq, &copy.at(0), &map.at(0));
+	}
+
+	Cond(NotEq, arena.reserved_byte_count(), 0);
+}
+
+DeclTest(allocator, arena_string)
+{
+	Arena arena;
+
+	auto str = String::create("A header name long enough to be a large string", arena);
+	auto pooled = String::create("A header name long enough to be a large string");
+
+	Cond(Eq, str.is_large_string(), true);
+	Cond(Eq, str, pooled);
+	Cond(Eq, pooled, str);
+	Cond(NotEq, str.data(), pooled.data());
+
+	// Arena strings are never pooled, but copies still share their storage
+	auto copy = str;
+	Cond(Eq, copy.data(), str.data());
+	Cond(Eq, copy.ref_count(), 2);
+
+	auto small = String::create("Small", arena);
+	Cond(Eq, small, "Small");
+}
@@ -1,14 +1,19 @@
+#include <Allocator.hpp>
 #include <Assert.hpp>
+#include <CodePointIndex.hpp>
 #include <CodePointIterator.hpp>
 #include <Concepts.hpp>
+#include <ConcurrentHashMap.hpp>
 #include <EnumFlags.hpp>
 #include <Hash.hpp>
 #include <HashMap.hpp>
 #include <Result.hpp>
 #include <Scoped.hpp>
+#include <SIMD.hpp>
 #include <Span.hpp>
 #include <String.hpp>
 #include <StringBase.hpp>
+#include <StringSearch.hpp>
 #include <StringView.hpp>
 #include <Tuple.hpp>
 #include <Types.hpp>
@@ -0,0 +1,93 @@
+#include "Test.hpp"
+
+#include <ConcurrentHashMap.hpp>
+#include <String.hpp>
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace CSTM;
+
+DeclTest(concurrent_hash_map, insert_access_remove)
+{
+	ConcurrentHashMap<size_t, std::string> map(8);
+	Cond(Eq, map.shard_count(), 8);
+
+	map.insert(0, "Hello, World!");
+	Cond(Eq, map.contains(0), true);
+	Cond(Eq, map.at(0), "Hello, World!");
+	CondManual(try { map.insert(0, "Again"); } catch (const std::runtime_error&) { pass = true; }, true);
+
+	Cond(Eq, map.try_emplace(0, "Again"), false);
+	Cond(Eq, map.try_emplace(1, "Second"), true);
+
+	map.insert_or_assign(0, "Assigned");
+	Cond(Eq, map[0], "Assigned");
+
+	bool visited = map.visit(1, [](std::string& value) { value += "!"; });
+	Cond(Eq, visited, true);
+	Cond(Eq, map[1], "Second!");
+	Cond(Eq, map.visit(2, [](std::string&) {}), false);
+
+	// Const maps only hand out const references
+	const bool visitedConst = std::as_const(map).visit(1, [](auto& value)
+	{
+		static_assert(std::is_const_v<std::remove_reference_t<decltype(value)>>);
+	});
+	Cond(Eq, visitedConst, true);
+
+	map.remove(0);
+	Cond(Eq, map.contains(0), false);
+	Cond(Eq, map.try_remove(0), false);
+	Cond(Eq, map.try_remove(1), true);
+	Cond(Eq, map.is_empty(), true);
+}
+
+DeclTest(concurrent_hash_map, transparent_lookup)
+{
+	ConcurrentHashMap<String, size_t> map;
+	map.insert(String::create("Hello"), 5);
+
+	Cond(Eq, map.contains(std::string_view{ "Hello" }), true);
+	Cond(Eq, map.at(std::string_view{ "Hello" }), 5);
+}
+
+DeclTest(concurrent_hash_map, parallel_insert_and_read)
+{
+	constexpr size_t ThreadCount = 4;
+	constexpr size_t KeysPerThread = 10000;
+
+	ConcurrentHashMap<size_t, size_t> map;
+	map.reserve(ThreadCount * KeysPerThread);
+
+	std::atomic<size_t> missingKeys = 0;
+
+	{
+		std::vector<std::jthread> threads;
+
+		for (size_t t = 0; t < ThreadCount; t++)
+		{
+			threads.emplace_back([&map, &missingKeys, t]
+			{
+				for (size_t i = t * KeysPerThread; i < (t + 1) * KeysPerThread; i++)
+				{
+					map.insert(i, i * 2);
+
+					if (!map.contains(i) || map.at(i) != i * 2)
+					{
+						missingKeys++;
+					}
+				}
+			});
+		}
+	}
+
+	Cond(Eq, missingKeys.load(), 0);
+	Cond(Eq, map.element_count(), ThreadCount * KeysPerThread);
+
+	size_t valueSum = 0;
+	std::as_const(map).for_each([&](const size_t& key, const size_t& value) { valueSum += value - key; });
+	Cond(Eq, valueSum, (ThreadCount * KeysPerThread) * (ThreadCount * KeysPerThread - 1) / 2);
+}
@@ -0,0 +1,59 @@
+#include "Test.hpp"
+
+#include <Hash.hpp>
+#include <String.hpp>
+#include <StringView.hpp>
+
+#include <set>
+
+using namespace CSTM;
+
+DeclTest(hash, hash_bytes_seeded)
+{
+	constexpr std::string_view text = "The quick brown fox jumps over the lazy dog";
+
+	Cond(Eq, hash_bytes(text.data(), text.size(), 1), hash_bytes(text.data(), text.size(), 1));
+	Cond(NotEq, hash_bytes(text.data(), text.size(), 1), hash_bytes(text.data(), text.size(), 2));
+
+	// Every prefix (which covers every code path) has to hash differently
+	std::set<size_t> hashes;
+
+	for (size_t i = 0; i <= text.size(); i++)
+	{
+		hashes.insert(hash_bytes(text.data(), i, 1));
+	}
+
+	Cond(Eq, hashes.size(), text.size() + 1);
+
+	// Same bytes at a different address
+	std::string copy{ text };
+	Cond(Eq, hash_bytes(copy.data(), copy.size(), 1), hash_bytes(text.data(), text.size(), 1));
+}
+
+DeclTest(hash, hash_integer_seeded)
+{
+	Cond(Eq, hash_integer(42, 1), hash_integer(42, 1));
+	Cond(NotEq, hash_integer(42, 1), hash_integer(42, 2));
+
+	std::set<size_t> hashes;
+
+	for (uint64_t i = 0; i < 1000; i++)
+	{
+		hashes.insert(hash_integer(i, 1));
+	}
+
+	Cond(Eq, hashes.size(), 1000);
+}
+
+DeclTest(hash, secure_hash_strings)
+{
+	const auto str = String::create("A header name long enough to be a large string");
+	const auto view = str.view().value();
+
+	SecureHash<String> hash;
+	Cond(Eq, hash(str), hash(view));
+	Cond(Eq, hash(str), hash(std::string_view{ "A header name long enough to be a large string" }));
+	Cond(Eq, hash(str), StringHash{}(str, SecureHash<String>::GlobalSeed));
+
+	Cond(Eq, SecureHash<std::string>{}("Hello"), hash_bytes("Hello", 5, SecureHash<std::string>::GlobalSeed));
+}
@@ -1,6 +1,10 @@
 #include "Test.hpp"
 
 #include <HashMap.hpp>
+#include <String.hpp>
+#include <StringView.hpp>
+
+#include <ranges>
 
 using namespace CSTM;
 
@@ -11,3 +15,333 @@ DeclTest(hash_map, insert_access_remove)
 	const auto& v = map[0];
 	map.remove(0);
 }
+
+DeclTest(hash_map, grow_and_reuse_deleted)
+{
+	DeterministicHashMap<size_t, size_t> map;
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		map.insert(i, i * 2);
+	}
+
+	Cond(Eq, map.element_count(), 1000);
+	Cond(Eq, map[500], 1000);
+	Cond(Eq, map.contains(1000), false);
+
+	for (size_t i = 0; i < 1000; i += 2)
+	{
+		map.remove(i);
+	}
+
+	Cond(Eq, map.element_count(), 500);
+	Cond(Eq, map.contains(500), false);
+	Cond(Eq, map.contains(501), true);
+
+	map.insert(500, 1);
+	Cond(Eq, map[500], 1);
+
+	const auto copy = map;
+	Cond(Eq, copy.element_count(), 501);
+	Cond(Eq, copy[999], 1998);
+}
+
+DeclTest(hash_map, power_of_two_buckets)
+{
+	DeterministicHashMap<size_t, size_t> map(100);
+	Cond(Eq, map.bucket_count(), 128);
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		map.insert(i << 32, i);
+	}
+
+	Cond(Eq, std::has_single_bit(map.bucket_count()), true);
+	Cond(Eq, map[999ull << 32], 999);
+}
+
+DeclTest(hash_map, rehash_moves_elements)
+{
+	struct CopyCounter
+	{
+		size_t* copies;
+
+		CopyCounter(size_t* copies) : copies(copies) {}
+		CopyCounter(const CopyCounter& other) : copies(other.copies) { (*copies)++; }
+		CopyCounter(CopyCounter&& other) noexcept = default;
+	};
+
+	size_t copies = 0;
+	DeterministicHashMap<size_t, CopyCounter> map;
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		map.insert(i, CopyCounter{ &copies });
+	}
+
+	// Only the copy made by insert itself, growing the map should move
+	Cond(Eq, copies, 1000);
+
+	const size_t bucketCount = map.bucket_count();
+
+	// Churn through enough tombstones to force the map to clean them up
+	for (size_t i = 0; i < 10000; i++)
+	{
+		map.remove(i);
+		map.insert(i + 1000, CopyCounter{ &copies });
+	}
+
+	Cond(Eq, copies, 11000);
+	Cond(Eq, map.bucket_count(), bucketCount);
+	Cond(Eq, map.element_count(), 1000);
+	Cond(Eq, map.contains(10999), true);
+	Cond(Eq, map.contains(9999), false);
+}
+
+// Counts how often a key is hashed
+struct CountingHash
+{
+	inline static size_t Count = 0;
+
+	size_t operator()(const std::string& key) const
+	{
+		Count++;
+		return std::hash<std::string>{}(key);
+	}
+};
+
+DeclTest(hash_map, cached_hashes)
+{
+	BasicHashMap<std::string, size_t, CountingHash, true> cached;
+	BasicHashMap<std::string, size_t, CountingHash, false> uncached;
+
+	CountingHash::Count = 0;
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		cached.insert(std::to_string(i), i);
+	}
+
+	// Growing the map reuses the cached hashes
+	Cond(Eq, CountingHash::Count, 1000);
+
+	CountingHash::Count = 0;
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		uncached.insert(std::to_string(i), i);
+	}
+
+	Cond(NotEq, CountingHash::Count, 1000);
+
+	// Churn through enough tombstones to force the map to clean them up in place
+	const size_t bucketCount = cached.bucket_count();
+
+	for (size_t i = 0; i < 10000; i++)
+	{
+		cached.remove(std::to_string(i));
+		cached.insert(std::to_string(i + 1000), i + 1000);
+	}
+
+	Cond(Eq, cached.bucket_count(), bucketCount);
+	Cond(Eq, cached.element_count(), 1000);
+	Cond(Eq, cached.contains("10999"), true);
+	Cond(Eq, cached.at("10500"), 10500);
+	Cond(Eq, cached.contains("9999"), false);
+
+	const auto copy = cached;
+	Cond(Eq, copy.at("10999"), 10999);
+}
+
+DeclTest(hash_map, reserve)
+{
+	DeterministicHashMap<size_t, size_t> map;
+	map.reserve(10000);
+
+	const size_t bucketCount = map.bucket_count();
+
+	for (size_t i = 0; i < 10000; i++)
+	{
+		map.insert(i, i);
+	}
+
+	Cond(Eq, map.bucket_count(), bucketCount);
+	Cond(Eq, map.element_count(), 10000);
+}
+
+DeclTest(hash_map, insert_range)
+{
+	std::vector<std::pair<size_t, size_t>> elements;
+
+	for (size_t i = 0; i < 5000; i++)
+	{
+		elements.emplace_back(i, i * 3);
+	}
+
+	auto map = DeterministicHashMap<size_t, size_t>::from_unique(elements);
+	Cond(Eq, map.element_count(), 5000);
+	Cond(Eq, map[4999], 14997);
+
+	const size_t bucketCount = map.bucket_count();
+	map.reserve(10000);
+	Cond(NotEq, map.bucket_count(), bucketCount);
+	Cond(Eq, map[1234], 3702);
+
+	DeterministicHashMap<size_t, size_t> other{ { 1, 2 }, { 3, 4 } };
+	Cond(Eq, other[3], 4);
+
+	// Both maps contain the key 1
+	CondManual(try { other.insert_range(elements); } catch (const std::runtime_error&) { pass = true; }, true);
+}
+
+DeclTest(hash_map, try_emplace)
+{
+	HashMap<size_t, std::string> map;
+
+	const auto inserted = map.try_emplace(5, 3, 'a');
+	Cond(Eq, inserted.has_value(), true);
+	Cond(Eq, inserted.value(), "aaa");
+
+	const auto duplicate = map.try_emplace(5, "bbb");
+	Cond(Eq, duplicate.has_error(), true);
+	Cond(Eq, duplicate.error(), HashMapError::KeyAlreadyPresent);
+	Cond(Eq, map[5], "aaa");
+
+	Cond(Eq, map.emplace(6, "ccc").has_value(), true);
+	Cond(Eq, map.emplace(std::make_pair(6, "ddd")).has_error(), true);
+	Cond(Eq, map[6], "ccc");
+
+	map.insert_or_assign(6, "eee");
+	map.insert_or_assign(7, "fff");
+	Cond(Eq, map[6], "eee");
+	Cond(Eq, map[7], "fff");
+	Cond(Eq, map.element_count(), 3);
+}
+
+DeclTest(hash_map, find)
+{
+	HashMap<size_t, std::string> map;
+	map.insert(5, "aaa");
+
+	std::string* value = map.find(5);
+	Cond(NotEq, value, nullptr);
+	*value = "bbb";
+	Cond(Eq, map[5], "bbb");
+
+	Cond(Eq, map.find(6), nullptr);
+	static_assert(std::same_as<decltype(std::as_const(map).find(5)), const std::string*>);
+	static_assert(std::same_as<decltype(map.find(5)), std::string*>);
+}
+
+DeclTest(hash_map, try_remove)
+{
+	HashMap<size_t, std::string> map;
+	map.insert(5, "aaa");
+
+	Cond(Eq, map.try_remove(6), false);
+	Cond(Eq, map.try_remove(5), true);
+	Cond(Eq, map.try_remove(5), false);
+	Cond(Eq, map.is_empty(), true);
+}
+
+DeclTest(hash_map, transparent_lookup)
+{
+	HashMap<String, size_t> map;
+	map.insert(String::create("Content-Type"), 1);
+	map.insert(String::create("A header name long enough to be a large string"), 2);
+
+	const auto small = String::create("Content-Type");
+	const auto large = String::create("A header name long enough to be a large string");
+
+	Cond(Eq, map.contains(small), true);
+	Cond(Eq, map.contains("Content-Type"), true);
+	Cond(Eq, map.contains(std::string_view{ "Content-Type" }), true);
+	Cond(Eq, map.contains(small.view().value()), true);
+	Cond(Eq, map.contains(large.view().value()), true);
+	Cond(Eq, map.contains(large.view(2).value()), false);
+	Cond(Eq, map["A header name long enough to be a large string"], 2);
+
+	constexpr auto bytes = std::array<byte, 12>{ 'C', 'o', 'n', 't', 'e', 'n', 't', '-', 'T', 'y', 'p', 'e' };
+	Cond(Eq, map.at(Span<byte>{ bytes }), 1);
+
+	map.remove(std::string_view{ "Content-Type" });
+	Cond(Eq, map.contains(small), false);
+}
+
+DeclTest(hash_map, iteration)
+{
+	static_assert(std::forward_iterator<HashMap<size_t, size_t>::Iterator>);
+	static_assert(std::forward_iterator<HashMap<size_t, size_t>::ConstIterator>);
+
+	DeterministicHashMap<size_t, size_t> map;
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		map.insert(i, i);
+	}
+
+	for (size_t i = 0; i < 1000; i += 3)
+	{
+		map.remove(i);
+	}
+
+	size_t count = 0;
+	size_t keySum = 0;
+
+	for (auto [key, value] : map)
+	{
+		value *= 2;
+		keySum += key;
+		count++;
+	}
+
+	Cond(Eq, count, map.element_count());
+	Cond(Eq, map[1], 2);
+
+	size_t valueSum = 0;
+	std::as_const(map).for_each([&](const size_t, const size_t value) { valueSum += value; });
+	Cond(Eq, valueSum, keySum * 2);
+
+	size_t visited = 0;
+	map.for_each([&](const size_t, size_t&)
+	{
+		visited++;
+		return visited < 10 ? IterAction::Continue : IterAction::Break;
+	});
+	Cond(Eq, visited, 10);
+
+	for (auto& value : map.values())
+	{
+		value = 0;
+	}
+
+	Cond(Eq, map[2], 0);
+	Cond(Eq, std::ranges::distance(map.keys()), map.element_count());
+
+	size_t keysSum = 0;
+
+	for (const size_t key : map.keys())
+	{
+		keysSum += key;
+	}
+
+	Cond(Eq, keysSum, keySum);
+
+	DeterministicHashMap<size_t, size_t> empty;
+	Cond(Eq, empty.begin(), empty.end());
+}
+
+DeclTest(hash_map, clear_moved_from)
+{
+	HashMap<size_t, std::string> map;
+	map.insert(1, "Hello, World!");
+
+	HashMap<size_t, std::string> other(std::move(map));
+	map.clear();
+	Cond(Eq, map.element_count(), 0);
+
+	map.insert(2, "Goodbye, World!");
+	Cond(Eq, map.element_count(), 1);
+	Cond(Eq, map[2], "Goodbye, World!");
+	Cond(Eq, other[1], "Hello, World!");
+}
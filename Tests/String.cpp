@@ -4,6 +4,10 @@
 #include <StringView.hpp>
 #include <CodePointIterator.hpp>
 
+#include <format>
+#include <thread>
+#include <vector>
+
 using namespace CSTM;
 
 DeclTest(string, large_small_string)
@@ -14,6 +18,21 @@ DeclTest(string, large_small_string)
 	Cond(Eq, largeString.is_large_string(), true);
 }
 
+DeclTest(string, small_string_length)
+{
+	const std::string longest(String::SmallStringLength, 'a');
+	const std::string shortest(String::SmallStringLength + 1, 'a');
+
+	const auto smallString = String::create(longest);
+	const auto largeString = String::create(shortest);
+	Cond(Eq, smallString.is_large_string(), false);
+	Cond(Eq, smallString.byte_count(), String::SmallStringLength);
+	Cond(Eq, smallString, longest);
+	Cond(Eq, largeString.is_large_string(), true);
+	Cond(Eq, largeString, shortest);
+	Cond(NotEq, smallString, largeString);
+}
+
 DeclTest(string, ref_count)
 {
 	const auto smallString = String::create("Hello, World!");
@@ -21,7 +40,7 @@ DeclTest(string, ref_count)
 	Cond(Eq, smallString.ref_count(), 1);
 	Cond(Eq, smallStringCopy.ref_count(), 1);
 
-	const auto largeString = String::create("Hello, Cruel World!");
+	const auto largeString = String::create("Hello, Cruel World! My name is Bob!");
 	Cond(Eq, largeString.ref_count(), 1);
 
 	const auto largeStringCopy = largeString;
@@ -29,7 +48,7 @@ DeclTest(string, ref_count)
 	Cond(Eq, largeStringCopy.ref_count(), 2);
 
 	{
-		const auto largeString1 = String::create("Hello, Cruel World!");
+		const auto largeString1 = String::create("Hello, Cruel World! My name is Bob!");
 		Cond(Eq, largeString.ref_count(), 3);
 		Cond(Eq, largeStringCopy.ref_count(), 3);
 		Cond(Eq, largeString1.ref_count(), 3);
@@ -39,6 +58,83 @@ DeclTest(string, ref_count)
 	Cond(Eq, largeStringCopy.ref_count(), 2);
 }
 
+DeclTest(string, concurrent_pool)
+{
+	constexpr size_t ThreadCount = 4;
+
+	const auto shared = String::create("A string that every thread interns over and over again");
+
+	{
+		std::vector<std::jthread> threads;
+
+		for (size_t t = 0; t < ThreadCount; t++)
+		{
+			threads.emplace_back([t]
+			{
+				for (size_t i = 0; i < 10000; i++)
+				{
+					const auto str = String::create("A string that every thread interns over and over again");
+					const auto copy = str;
+
+					// Strings that are only alive for a moment, which makes them enter and leave the pool constantly
+					const auto temporary = String::create(std::format("Temporary string {} of thread {}", i % 16, t));
+				}
+			});
+		}
+	}
+
+	Cond(Eq, shared.ref_count(), 1);
+
+	const auto again = String::create("A string that every thread interns over and over again");
+	Cond(Eq, again.data(), shared.data());
+}
+
+DeclTest(string, pooled_by_content)
+{
+	std::vector<String> strings;
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		strings.push_back(String::create(std::format("A large string with the number {}", i)));
+	}
+
+	size_t mismatches = 0;
+
+	for (size_t i = 0; i < strings.size(); i++)
+	{
+		const auto again = String::create(std::format("A large string with the number {}", i));
+
+		if (again.data() != strings[i].data() || again != strings[i] || (i > 0 && strings[i] == strings[i - 1]))
+		{
+			mismatches++;
+		}
+	}
+
+	Cond(Eq, mismatches, 0);
+}
+
+DeclTest(string, create_unique)
+{
+	const auto pooled = String::create("A response body that nobody is ever going to compare");
+	const auto unique = String::create_unique("A response body that nobody is ever going to compare");
+	const auto otherUnique = String::create_unique("A response body that nobody is ever going to compare");
+
+	Cond(Eq, unique.is_large_string(), true);
+	Cond(NotEq, unique.data(), pooled.data());
+	Cond(NotEq, unique.data(), otherUnique.data());
+	Cond(Eq, unique, pooled);
+	Cond(Eq, unique, otherUnique);
+	Cond(Eq, pooled.ref_count(), 1);
+
+	{
+		const auto copy = unique;
+		Cond(Eq, copy.data(), unique.data());
+		Cond(Eq, unique.ref_count(), 2);
+	}
+
+	Cond(Eq, unique.ref_count(), 1);
+}
+
 DeclTest(string, equals)
 {
 	// Small-string - Small-string comparison
@@ -51,8 +147,8 @@ DeclTest(string, equals)
 	Cond(NotEq, smallString1, smallString2);
 
 	// Large-string - Large-string comparison
-	const auto largeString = String::create("Hello, Cruel World!");
-	const auto largeString1 = String::create("Hello, Cruel World!");
+	const auto largeString = String::create("Hello, Cruel World! My name is Bob!");
+	const auto largeString1 = String::create("Hello, Cruel World! My name is Bob!");
 	const auto largeString2 = String::create("Goodbye, Cruel World!");
 	Cond(Eq, largeString, largeString1);
 	Cond(Eq, largeString1, largeString);
@@ -187,4 +283,89 @@ DeclTest(string, remove_any)
 	auto str = String::create("Hello, World");
 	str = str.remove_any("l").value_or(str);
 	Cond(Eq, str, "Heo, Word");
-}
\ No newline at end of file
+}
+
+DeclTest(string, try_create)
+{
+	const auto valid = String::try_create("Hello, \xE4\xBD\xA0\xE5\xA5\xBD");
+	Cond(Eq, valid.has_value(), true);
+	Cond(Eq, valid.value(), "Hello, \xE4\xBD\xA0\xE5\xA5\xBD");
+
+	// Truncated sequence at the end
+	Cond(Eq, String::try_create("Hello, \xE4\xBD").has_error(), true);
+
+	const byte overlong[] = { 'a', 0xC0, 0xAF };
+	Cond(Eq, String::try_create(Span<byte>(overlong, overlong + sizeof(overlong))).has_error(), true);
+}
+
+DeclTest(string, unicode_metadata)
+{
+	const auto ascii = String::create("Hello, Cruel World! My name is Bob!");
+	Cond(Eq, ascii.code_point_count(), 35);
+	Cond(Eq, ascii.is_ascii(), true);
+	Cond(Eq, ascii.is_valid_utf8(), true);
+
+	// Copies share the storage, and with it whatever was cached
+	const auto copy = ascii;
+	Cond(Eq, copy.code_point_count(), 35);
+	Cond(Eq, copy.is_ascii(), true);
+
+	const auto cjk = String::create("\xE4\xBD\xA0\xE5\xA5\xBD\xE4\xBD\xA0\xE5\xA5\xBD\xE4\xBD\xA0\xE5\xA5\xBD\xE4\xBD\xA0\xE5\xA5\xBD");
+	Cond(Eq, cjk.code_point_count(), 8);
+	Cond(Eq, cjk.code_point_count(), 8);
+	Cond(Eq, cjk.is_ascii(), false);
+	Cond(Eq, cjk.is_valid_utf8(), true);
+
+	// As many code points as bytes, but not ASCII
+	const auto invalid = String::create_unique("\xFF\xFE Not quite ASCII, or UTF-8 for that matter");
+	Cond(Eq, invalid.is_valid_utf8(), false);
+	Cond(Eq, invalid.is_valid_utf8(), false);
+	Cond(Eq, invalid.is_ascii(), false);
+
+	const auto small = String::create("\xC3\xA9t\xC3\xA9");
+	Cond(Eq, small.code_point_count(), 3);
+	Cond(Eq, small.is_ascii(), false);
+	Cond(Eq, small.view().value().is_ascii(), false);
+	Cond(Eq, ascii.view(0, 5).value().is_ascii(), true);
+
+	const auto validated = String::try_create("Validated once when it was created, never again");
+	Cond(Eq, validated.value().is_valid_utf8(), true);
+}
+
+DeclTest(string, code_point_at)
+{
+	std::string text;
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		text += i % 2 == 0 ? "a" : "\xE4\xBD\xA0";
+	}
+
+	// Pooled, unique and arena strings take different paths, only the first two are indexed
+	Arena arena;
+	const String strings[] = { String::create(text), String::create_unique(text), String::create(text, arena) };
+
+	// NOTE(Peter): Compared as views, since comparing against a char literal would compare signed chars with bytes
+	const auto expected = String::create("a\xE4\xBD\xA0" "a");
+
+	for (const auto& str : strings)
+	{
+		Cond(Eq, str.code_point_at(0).value(), 'a');
+		Cond(Eq, str.code_point_at(1).value(), 0x4F60);
+		Cond(Eq, str.code_point_at(998).value(), 'a');
+		Cond(Eq, str.code_point_at(999).value(), 0x4F60);
+		Cond(Eq, str.code_point_at(1000).has_error(), true);
+
+		// Both of these are past the first Stride code points
+		Cond(Eq, str.view_code_points(600, 3).value(), expected.view().value());
+		Cond(Eq, str.view_code_points(999).value(), expected.view(1, 3).value());
+		Cond(Eq, str.view_code_points(1000).has_error(), true);
+		Cond(Eq, str.view_code_points(990, 11).has_error(), true);
+	}
+
+	const auto small = String::create("\xC3\xA9t\xC3\xA9");
+	Cond(Eq, small.code_point_at(2).value(), 0xE9);
+	Cond(Eq, small.code_point_at(3).has_error(), true);
+	Cond(Eq, small.view().value().code_point_at(1).value(), 't');
+	Cond(Eq, CodePointIterator{ small }.code_point_at(3).has_error(), true);
+}
@@ -0,0 +1,144 @@
+#include "Test.hpp"
+
+#include <String.hpp>
+#include <StringSearch.hpp>
+#include <StringView.hpp>
+
+#include <random>
+#include <string>
+#include <string_view>
+
+using namespace CSTM;
+
+DeclTest(string_search, find)
+{
+	const auto str = String::create("GET /index.html HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\n\r\n<html></html>");
+
+	Cond(Eq, str.find("\r\n"), 24);
+	Cond(Eq, str.find("\r\n", 25), 43);
+	Cond(Eq, str.rfind("\r\n"), 58);
+	Cond(Eq, str.find("\r\n\r\n"), 56);
+	Cond(Eq, str.find("Content-Length"), NotFound);
+	Cond(Eq, str.find(""), 0);
+	Cond(Eq, str.rfind(""), str.byte_count());
+	Cond(Eq, str.find("G"), 0);
+	Cond(Eq, str.rfind(">"), str.byte_count() - 1);
+	Cond(Eq, str.contains("Host: example.com"), true);
+	Cond(Eq, str.contains("Host: example.org"), false);
+
+	const auto offsets = str.find_all("\r\n");
+	const std::vector<size_t> expectedOffsets = { 24, 43, 56, 58 };
+	Cond(Eq, offsets, expectedOffsets);
+
+	// Occurrences don't overlap
+	const auto repeated = String::create("aaaaaaa");
+	Cond(Eq, repeated.find_all("aa").size(), 3);
+
+	const auto view = str.view(4, 11).value();
+	Cond(Eq, view.find("."), 6);
+	Cond(Eq, view.find("HTTP"), NotFound);
+}
+
+DeclTest(string_search, matches_std)
+{
+	std::mt19937_64 random(1234);
+
+	// NOTE(Peter): A tiny alphabet causes a lot of partial matches, and long needles use a different algorithm
+	size_t mismatches = 0;
+
+	for (size_t iteration = 0; iteration < 2000; iteration++)
+	{
+		const size_t alphabetSize = 2 + random() % 3;
+		const auto randomString = [&](size_t length)
+		{
+			std::string result(length, '\0');
+
+			for (auto& c : result)
+			{
+				c = static_cast<char>('a' + random() % alphabetSize);
+			}
+
+			return result;
+		};
+
+		const std::string haystack = randomString(random() % 300);
+		std::string needle = randomString(1 + random() % 70);
+
+		// Make sure that we actually find something most of the time
+		if (haystack.size() > needle.size() && random() % 2 == 0)
+		{
+			needle = haystack.substr(random() % (haystack.size() - needle.size()), needle.size());
+		}
+
+		const auto* haystackBytes = reinterpret_cast<const byte*>(haystack.data());
+		const auto* needleBytes = reinterpret_cast<const byte*>(needle.data());
+		const size_t expectedFind = std::string_view{ haystack }.find(needle);
+		const size_t expectedRFind = std::string_view{ haystack }.rfind(needle);
+
+		if (find_bytes(haystackBytes, haystack.size(), needleBytes, needle.size()) != (expectedFind == std::string_view::npos ? NotFound : expectedFind) ||
+			rfind_bytes(haystackBytes, haystack.size(), needleBytes, needle.size()) != (expectedRFind == std::string_view::npos ? NotFound : expectedRFind))
+		{
+			mismatches++;
+		}
+	}
+
+	Cond(Eq, mismatches, 0);
+}
+
+DeclTest(string_search, find_first_of)
+{
+	const auto str = String::create("  \t key = value; other_key=\"some other value\"  \r\n");
+
+	Cond(Eq, str.find_first_not_of(" \t"), 4);
+	Cond(Eq, str.find_first_of("=;"), 8);
+	Cond(Eq, str.find_first_of("=;", 9), 15);
+	Cond(Eq, str.find_last_of("=;"), 26);
+	Cond(Eq, str.find_last_not_of(" \r\n"), 44);
+	Cond(Eq, str.find_first_of("#"), NotFound);
+	Cond(Eq, str.find_first_of(""), NotFound);
+	Cond(Eq, str.find_first_not_of(""), 0);
+
+	const auto trimmed = str.remove_any(" \t\r\n\"").value();
+	Cond(Eq, trimmed, "key=value;other_key=someothervalue");
+}
+
+DeclTest(string_search, byte_set_matches_std)
+{
+	std::mt19937_64 random(4321);
+
+	size_t mismatches = 0;
+
+	for (size_t iteration = 0; iteration < 2000; iteration++)
+	{
+		// NOTE(Peter): Including bytes >= 0x80, since those are looked up in a separate table
+		std::string haystack(random() % 200, '\0');
+
+		for (auto& c : haystack)
+		{
+			c = static_cast<char>(random() % 2 == 0 ? 'a' + random() % 8 : random() % 256);
+		}
+
+		std::string chars(random() % 12, '\0');
+
+		for (auto& c : chars)
+		{
+			c = static_cast<char>(random() % 2 == 0 ? 'a' + random() % 8 : random() % 256);
+		}
+
+		const ByteSet set{ reinterpret_cast<const byte*>(chars.data()), chars.size() };
+		const auto* bytes = reinterpret_cast<const byte*>(haystack.data());
+
+		const auto expected = [](size_t offset) { return offset == std::string_view::npos ? NotFound : offset; };
+		const std::string_view view{ haystack };
+
+		if (set.find_first_in(bytes, haystack.size()) != expected(view.find_first_of(chars)) ||
+			set.find_first_not_in(bytes, haystack.size()) != expected(view.find_first_not_of(chars)) ||
+			set.find_last_in(bytes, haystack.size()) != expected(view.find_last_of(chars)) ||
+			set.find_last_not_in(bytes, haystack.size()) != expected(view.find_last_not_of(chars)))
+		{
+			mismatches++;
+		}
+	}
+
+	Cond(Eq, mismatches, 0);
+}
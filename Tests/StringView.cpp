@@ -71,3 +71,16 @@ DeclTest(string_view, starts_with_any)
 	Cond(Eq, strView.starts_with_any(std::string_view{"KJHW"}), true);
 	Cond(Eq, strView.starts_with_any(std::string_view{"Abc"}), false);
 }
+
+DeclTest(string_view, layout)
+{
+	static_assert(sizeof(StringView) == sizeof(const byte*) + sizeof(size_t));
+	static_assert(std::is_trivially_copyable_v<StringView>);
+	static_assert(sizeof(String) == String::SmallStringLength + 1);
+
+	const auto str = String::create("Hello, World!");
+	const StringView view = str.view().value();
+	Cond(Eq, view.starts_with("Hello"), true);
+	Cond(Eq, str.ends_with("World!"), true);
+	Cond(Eq, StringHash{}(view), StringHash{}(str));
+}
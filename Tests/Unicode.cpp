@@ -0,0 +1,278 @@
+#include "Test.hpp"
+
+#include <CodePointIndex.hpp>
+#include <CodePointIterator.hpp>
+#include <String.hpp>
+#include <Unicode.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace CSTM;
+
+// Random code points, mostly from the given range but mixed with ASCII and code points of every other encoded length
+static std::vector<uint32_t> random_code_points(std::mt19937_64& random, size_t count, uint32_t first, uint32_t last)
+{
+	std::vector<uint32_t> codePoints;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		switch (random() % 8)
+		{
+		case 0: codePoints.push_back(0x20 + random() % 0x5F); break;
+		case 1: codePoints.push_back(0x80 + random() % 0x780); break;
+		case 2: codePoints.push_back(0x1F600 + random() % 0x50); break;
+		default: codePoints.push_back(first + random() % (last - first + 1)); break;
+		}
+	}
+
+	return codePoints;
+}
+
+static std::vector<byte> encode(const std::vector<uint32_t>& codePoints)
+{
+	std::vector<byte> bytes;
+
+	for (uint32_t codePoint : codePoints)
+	{
+		uint32_t byteCount = 0;
+		const auto encoded = utf32_to_utf8(codePoint, byteCount);
+		bytes.insert(bytes.end(), encoded.begin(), encoded.begin() + byteCount);
+	}
+
+	return bytes;
+}
+
+DeclTest(unicode, decode_utf8)
+{
+	std::mt19937_64 random(5678);
+
+	// ASCII, Cyrillic and CJK heavy text, each of them takes a different path through the decoder
+	const std::pair<uint32_t, uint32_t> ranges[] = { { 0x20, 0x7E }, { 0x0400, 0x04FF }, { 0x4E00, 0x9FFF } };
+
+	size_t mismatches = 0;
+
+	for (size_t iteration = 0; iteration < 300; iteration++)
+	{
+		const auto [first, last] = ranges[iteration % 3];
+		const auto codePoints = random_code_points(random, random() % 200, first, last);
+		const auto bytes = encode(codePoints);
+
+		std::vector<uint32_t> decoded(bytes.size() + 32);
+		const auto result = decode_utf8(bytes.data(), bytes.size(), decoded.data(), decoded.size());
+		decoded.resize(result.code_point_count);
+
+		std::vector<uint32_t> forward;
+		CodePointIterator{ bytes.data(), bytes.size() }.store(forward);
+
+		std::vector<uint32_t> backward;
+		CodePointReverseIterator{ bytes.data(), bytes.size() }.store(backward);
+		std::ranges::reverse(backward);
+
+		if (result.byte_count != bytes.size() || decoded != codePoints || forward != codePoints || backward != codePoints ||
+			CodePointIterator{ bytes.data(), bytes.size() }.count() != codePoints.size())
+		{
+			mismatches++;
+		}
+	}
+
+	Cond(Eq, mismatches, 0);
+}
+
+DeclTest(unicode, decode_utf8_partial)
+{
+	// Decoding stops once the output is full
+	const auto str = String::create("\xE4\xBD\xA0\xE5\xA5\xBD, World");
+	uint32_t codePoints[2];
+	const auto result = decode_utf8(str.data(), str.byte_count(), codePoints, 2);
+	Cond(Eq, result.byte_count, 6);
+	Cond(Eq, result.code_point_count, 2);
+	Cond(Eq, codePoints[0], 0x4F60);
+	Cond(Eq, codePoints[1], 0x597D);
+}
+
+DeclTest(unicode, decode_invalid_utf8)
+{
+	// A stray trailing byte, a truncated sequence and a byte that can't start a sequence at all
+	const byte bytes[] = { 'a', 0x80, 'b', 0xE4, 0xBD, 'c', 0xFF };
+	const std::vector<uint32_t> expected = { 'a', ReplacementCodePoint, 'b', ReplacementCodePoint, ReplacementCodePoint, 'c', ReplacementCodePoint };
+
+	std::vector<uint32_t> codePoints;
+	CodePointIterator{ bytes, sizeof(bytes) }.store(codePoints);
+	Cond(Eq, codePoints, expected);
+}
+
+DeclTest(unicode, decode_non_shortest_utf8)
+{
+	constexpr uint32_t R = ReplacementCodePoint;
+
+	// Overlong '/', an overlong three byte sequence, a surrogate, a four byte sequence above U+10FFFF and an F5 leading byte,
+	// each of them replaced one byte at a time
+	const byte bytes[] = { 0xC0, 0xAF, 'a', 0xE0, 0x80, 0x80, 'b', 0xED, 0xA0, 0x80, 'c', 0xF4, 0x90, 0x80, 0x80, 0xF5, 0x80, 0x80, 0x80 };
+	const std::vector<uint32_t> expected = { R, R, 'a', R, R, R, 'b', R, R, R, 'c', R, R, R, R, R, R, R, R };
+
+	std::vector<uint32_t> codePoints;
+	CodePointIterator{ bytes, sizeof(bytes) }.store(codePoints);
+	Cond(Eq, codePoints, expected);
+
+	// Runs of two and three byte sequences go through the SSSE3 decoders, which have to reject these as well
+	const byte twoByteRun[] = { 0xD0, 0xB0, 0xC1, 0xBF, 0xD0, 0xB0, 0xD0, 0xB0, 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x' };
+	const std::vector<uint32_t> twoByteExpected = { 0x430, R, R, 0x430, 0x430, 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x' };
+
+	codePoints.clear();
+	CodePointIterator{ twoByteRun, sizeof(twoByteRun) }.store(codePoints);
+	Cond(Eq, codePoints, twoByteExpected);
+
+	const byte threeByteRun[] = { 0xE4, 0xBD, 0xA0, 0xED, 0xA0, 0x80, 0xE0, 0x80, 0x80, 0xE4, 0xBD, 0xA0, 'x', 'x', 'x', 'x' };
+	const std::vector<uint32_t> threeByteExpected = { 0x4F60, R, R, R, R, R, R, 0x4F60, 'x', 'x', 'x', 'x' };
+
+	codePoints.clear();
+	CodePointIterator{ threeByteRun, sizeof(threeByteRun) }.store(codePoints);
+	Cond(Eq, codePoints, threeByteExpected);
+}
+
+DeclTest(unicode, validate_utf8)
+{
+	std::mt19937_64 random(91011);
+
+	// Every invalid case, placed at random offsets so they end up in every lane and across block boundaries
+	const std::vector<std::vector<byte>> invalidSequences = {
+		{ 0x80 },						// Stray trailing byte
+		{ 0xC3 },						// Truncated two byte sequence
+		{ 0xE4, 0xBD },					// Truncated three byte sequence
+		{ 0xF0, 0x9F, 0x98 },			// Truncated four byte sequence
+		{ 0xC0, 0xAF },					// Overlong two byte sequence
+		{ 0xE0, 0x80, 0xAF },			// Overlong three byte sequence
+		{ 0xF0, 0x80, 0x80, 0xAF },		// Overlong four byte sequence
+		{ 0xED, 0xA0, 0x80 },			// Surrogate
+		{ 0xF4, 0x90, 0x80, 0x80 },		// Above U+10FFFF
+		{ 0xF5, 0x80, 0x80, 0x80 },		// Leading byte that can't occur
+		{ 0xFF },
+		{ 0xE4, 0xBD, 0xA0, 0x80 },		// Too many trailing bytes
+	};
+
+	size_t mismatches = 0;
+
+	for (size_t iteration = 0; iteration < 300; iteration++)
+	{
+		auto bytes = encode(random_code_points(random, random() % 100, 0x4E00, 0x9FFF));
+
+		if (!validate_utf8(bytes.data(), bytes.size()))
+		{
+			mismatches++;
+		}
+
+		// Only insert at code point boundaries, that way the rest of the bytes stay valid
+		size_t offset = random() % (bytes.size() + 1);
+
+		while (offset < bytes.size() && !is_leading_byte(bytes[offset]))
+		{
+			offset++;
+		}
+
+		const auto& invalid = invalidSequences[iteration % invalidSequences.size()];
+		bytes.insert(bytes.begin() + static_cast<ptrdiff_t>(offset), invalid.begin(), invalid.end());
+
+		// NOTE(Peter): Truncated sequences followed by trailing bytes would complete them, put an ASCII byte in between
+		if (offset + invalid.size() < bytes.size())
+		{
+			bytes.insert(bytes.begin() + static_cast<ptrdiff_t>(offset + invalid.size()), byte('x'));
+		}
+
+		if (validate_utf8(bytes.data(), bytes.size()))
+		{
+			mismatches++;
+		}
+	}
+
+	Cond(Eq, mismatches, 0);
+
+	// The boundaries of every range are still valid
+	const byte boundaries[] = {
+		0x7F, 0xC2, 0x80, 0xDF, 0xBF, 0xE0, 0xA0, 0x80, 0xED, 0x9F, 0xBF, 0xEE, 0x80, 0x80,
+		0xEF, 0xBF, 0xBF, 0xF0, 0x90, 0x80, 0x80, 0xF4, 0x8F, 0xBF, 0xBF
+	};
+	Cond(Eq, validate_utf8(boundaries, sizeof(boundaries)), true);
+	Cond(Eq, validate_utf8(nullptr, 0), true);
+}
+
+DeclTest(unicode, count_code_points)
+{
+	std::mt19937_64 random(1213);
+
+	size_t mismatches = 0;
+
+	// NOTE(Peter): Long enough that some strings go through more than one batch of blocks (255 blocks of up to 32 bytes)
+	for (size_t iteration = 0; iteration < 60; iteration++)
+	{
+		const size_t codePointCount = iteration % 3 == 0 ? random() % 8000 : random() % 100;
+		const auto codePoints = random_code_points(random, codePointCount, 0x0400, 0x9FFF);
+		const auto bytes = encode(codePoints);
+
+		// Starting at every offset within a block
+		const size_t skipped = std::min<size_t>(iteration % 7, codePoints.size());
+		const size_t skippedBytes = encode(std::vector<uint32_t>(codePoints.begin(), codePoints.begin() + static_cast<ptrdiff_t>(skipped))).size();
+
+		if (count_code_points(bytes.data(), bytes.size()) != codePoints.size() ||
+			count_code_points(bytes.data() + skippedBytes, bytes.size() - skippedBytes) != codePoints.size() - skipped)
+		{
+			mismatches++;
+		}
+	}
+
+	Cond(Eq, mismatches, 0);
+
+	const auto str = String::create("\xE4\xBD\xA0\xE5\xA5\xBD, World");
+	Cond(Eq, str.code_point_count(), 9);
+	Cond(Eq, String::create("").code_point_count(), 0);
+
+	auto iterator = CodePointIterator{ str };
+	iterator.advance();
+	Cond(Eq, iterator.count(), 8);
+	Cond(Eq, iterator.advance(), false);
+}
+
+DeclTest(unicode, code_point_index)
+{
+	std::mt19937_64 random(1415);
+
+	size_t mismatches = 0;
+
+	for (size_t iteration = 0; iteration < 20; iteration++)
+	{
+		const auto codePoints = random_code_points(random, random() % 3000, 0x0400, 0x9FFF);
+		const auto bytes = encode(codePoints);
+		const CodePointIndex index(bytes.data(), bytes.size());
+
+		if (index.code_point_count() != codePoints.size())
+		{
+			mismatches++;
+		}
+
+		// Every code point (and the one past the end) starts right after the encoded code points before it
+		size_t expectedOffset = 0;
+
+		for (size_t i = 0; i <= codePoints.size(); i++)
+		{
+			if (index.byte_offset(i) != expectedOffset || code_point_offset(bytes.data(), bytes.size(), i) != expectedOffset)
+			{
+				mismatches++;
+			}
+
+			if (i < codePoints.size())
+			{
+				uint32_t byteCount = 0;
+				(void)utf32_to_utf8(codePoints[i], byteCount);
+				expectedOffset += byteCount;
+			}
+		}
+
+		if (index.byte_offset(codePoints.size() + 1) != bytes.size())
+		{
+			mismatches++;
+		}
+	}
+
+	Cond(Eq, mismatches, 0);
+}